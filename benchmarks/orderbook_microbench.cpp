@@ -0,0 +1,397 @@
+// Microbenchmarks for the matching primitives, one data-structure operation
+// at a time. Most cases take (book depth, orders per level) so a change can be
+// compared on empty, shallow and deep books:
+//
+//   ./build/benchmarks/orderbook_microbench --benchmark_filter=Sweep
+//
+// Benchmarks that disturb the book time only the operation under test with
+// TscClock (UseManualTime) and restore the book outside the timed region.
+//
+// FLASHMATCH_PERF=1 adds per-iteration hardware counters (cycles,
+// instructions, cache/TLB/branch misses) to every case where the kernel
+// allows perf_event_open. They cover the whole loop, including any untimed
+// restore work.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "flashmatch/matching_engine.hpp"
+#include "flashmatch/order_generator.hpp"
+#include "flashmatch/perf_counters.hpp"
+#include "flashmatch/symbol_map.hpp"
+#include "flashmatch/tsc_clock.hpp"
+#include "lock_free_queue/lock_free_queue.hpp"
+
+namespace {
+
+using fm::MatchingEngine;
+using fm::OrderBook;
+using fm::TscClock;
+
+constexpr double kTick = 0.01;
+constexpr std::int64_t kMidTicks = 10'000;
+// Resting quantity large enough that repeated fills never empty a level.
+constexpr std::uint64_t kDeepQuantity = std::uint64_t{1} << 40;
+
+// Level 0 is the best price on each side.
+double ask_price(std::int64_t level) { return static_cast<double>(kMidTicks + 1 + level) * kTick; }
+double bid_price(std::int64_t level) { return static_cast<double>(kMidTicks - 1 - level) * kTick; }
+
+Order make_order(std::uint64_t id, Side side, double price, std::uint64_t quantity,
+                 OrderType type = OrderType::LIMIT, std::string symbol = "SYM") {
+  return Order{id, std::move(symbol), side, price, quantity, type};
+}
+
+template <typename Book>
+void fill_side(Book &book, Side side, std::int64_t first_level, std::int64_t depth,
+               std::int64_t per_level, std::uint64_t quantity, std::uint64_t &id) {
+  for (std::int64_t level = first_level; level < first_level + depth; ++level) {
+    double price = side == Side::BUY ? bid_price(level) : ask_price(level);
+    for (std::int64_t i = 0; i < per_level; ++i) {
+      book.insertOrder(make_order(++id, side, price, quantity));
+    }
+  }
+}
+
+// Counts hardware events from construction to destruction and reports them
+// as per-iteration user counters. Construct immediately before the loop.
+class ScopedPerfCounters {
+public:
+  explicit ScopedPerfCounters(benchmark::State &state) : state_(state) {
+    const char *env = std::getenv("FLASHMATCH_PERF");
+    if (env != nullptr && *env != '\0' && *env != '0') {
+      counters_.emplace();
+      counters_->reset();
+      counters_->enable();
+    }
+  }
+  ~ScopedPerfCounters() {
+    if (!counters_) {
+      return;
+    }
+    counters_->disable();
+    fm::PerfCounts counts = counters_->read();
+    for (std::size_t i = 0; i < fm::kPerfEventCount; ++i) {
+      auto event = static_cast<fm::PerfEvent>(i);
+      if (counts.has(event)) {
+        state_.counters[fm::perf_event_name(event)] = benchmark::Counter(
+            static_cast<double>(counts[event]), benchmark::Counter::kAvgIterations);
+      }
+    }
+  }
+
+private:
+  benchmark::State &state_;
+  std::optional<fm::PerfCounters> counters_;
+};
+
+void record_ns(benchmark::State &state, const TscClock &clock, std::uint64_t start) {
+  state.SetIterationTime(static_cast<double>(clock.to_ns(clock.stop() - start)) * 1e-9);
+}
+
+// insertOrder at a random existing level, or at a new level when depth is 0.
+// The book is rebuilt (untimed) once it has grown by its original size.
+void BM_InsertOrder(benchmark::State &state) {
+  const std::int64_t depth = state.range(0);
+  const std::int64_t per_level = state.range(1);
+  const std::int64_t reset_every = std::max<std::int64_t>(256, depth * per_level);
+  const TscClock &clock = TscClock::instance();
+  std::mt19937_64 rng(1);
+  std::uint64_t id = 0;
+  OrderBook book;
+  std::int64_t inserted = reset_every;
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    if (inserted == reset_every) {
+      book = OrderBook();
+      fill_side(book, Side::BUY, 0, depth, per_level, 10, id);
+      inserted = 0;
+    }
+    std::int64_t level = depth > 0 ? static_cast<std::int64_t>(rng() % depth) : inserted;
+    Order order = make_order(++id, Side::BUY, bid_price(level), 10);
+    std::uint64_t start = clock.start();
+    book.insertOrder(order);
+    record_ns(state, clock, start);
+    ++inserted;
+  }
+}
+BENCHMARK(BM_InsertOrder)
+    ->ArgNames({"depth", "per_level"})
+    ->Args({0, 0})
+    ->Args({16, 1})
+    ->Args({16, 16})
+    ->Args({1024, 1})
+    ->Args({1024, 16})
+    ->Args({1024, 128})
+    ->UseManualTime();
+
+// A one-lot buy that fills against the front order of the best ask.
+void BM_MatchTopLevel(benchmark::State &state) {
+  std::uint64_t id = 0;
+  OrderBook book;
+  fill_side(book, Side::SELL, 0, state.range(0), state.range(1), kDeepQuantity, id);
+  fill_side(book, Side::BUY, 0, state.range(0), state.range(1), kDeepQuantity, id);
+  Order order = make_order(0, Side::BUY, ask_price(0), 1);
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    order.id = ++id;
+    benchmark::DoNotOptimize(book.match(order));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchTopLevel)
+    ->ArgNames({"depth", "per_level"})
+    ->ArgsProduct({{1, 16, 1024}, {1, 16}});
+
+// A buy that consumes the first `levels` ask levels in full. The swept levels
+// are restored untimed after each iteration.
+void BM_MatchSweep(benchmark::State &state) {
+  const std::int64_t levels = state.range(0);
+  const std::int64_t per_level = state.range(1);
+  const TscClock &clock = TscClock::instance();
+  std::uint64_t id = 0;
+  OrderBook book;
+  fill_side(book, Side::SELL, 0, levels + 16, per_level, 1, id);
+  fill_side(book, Side::BUY, 0, 16, per_level, 1, id);
+  const auto quantity = static_cast<std::uint64_t>(levels * per_level);
+  std::size_t trades = 0;
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    Order order = make_order(++id, Side::BUY, ask_price(levels - 1), quantity, OrderType::IOC);
+    std::uint64_t start = clock.start();
+    auto fills = book.match(order);
+    record_ns(state, clock, start);
+    trades += fills.size();
+    fill_side(book, Side::SELL, 0, levels, per_level, 1, id);
+  }
+  state.counters["trades_per_match"] =
+      static_cast<double>(trades) / static_cast<double>(std::max<std::int64_t>(state.iterations(), 1));
+}
+BENCHMARK(BM_MatchSweep)
+    ->ArgNames({"levels", "per_level"})
+    ->ArgsProduct({{1, 4, 16, 64}, {1, 8}})
+    ->UseManualTime();
+
+// An IOC buy priced below the best ask: no fill, book unchanged.
+void BM_IocMiss(benchmark::State &state) {
+  std::uint64_t id = 0;
+  OrderBook book;
+  fill_side(book, Side::SELL, 0, state.range(0), state.range(1), 10, id);
+  fill_side(book, Side::BUY, 0, state.range(0), state.range(1), 10, id);
+  Order order = make_order(0, Side::BUY, bid_price(0), 10, OrderType::IOC);
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    order.id = ++id;
+    benchmark::DoNotOptimize(book.match(order));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IocMiss)->ArgNames({"depth", "per_level"})->ArgsProduct({{1, 16, 1024}, {1, 16}});
+
+// MatchingEngine::submit round-robin over many symbols, each order a one-lot
+// IOC that fills at the top of its symbol's book.
+void BM_EngineSubmit(benchmark::State &state) {
+  const std::int64_t symbols = state.range(0);
+  std::uint64_t id = 0;
+  MatchingEngine engine;
+  std::vector<Order> orders;
+  for (std::int64_t s = 0; s < symbols; ++s) {
+    std::string symbol = "SYM" + std::to_string(s);
+    for (std::int64_t level = 0; level < 16; ++level) {
+      engine.insert(make_order(++id, Side::SELL, ask_price(level), kDeepQuantity,
+                               OrderType::LIMIT, symbol));
+      engine.insert(make_order(++id, Side::BUY, bid_price(level), kDeepQuantity,
+                               OrderType::LIMIT, symbol));
+    }
+    orders.push_back(make_order(0, Side::BUY, ask_price(0), 1, OrderType::IOC, symbol));
+    orders.push_back(make_order(0, Side::SELL, bid_price(0), 1, OrderType::IOC, symbol));
+  }
+  std::size_t next = 0;
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    Order &order = orders[next];
+    order.id = ++id;
+    benchmark::DoNotOptimize(engine.submit(order));
+    next = next + 1 == orders.size() ? 0 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EngineSubmit)->ArgName("symbols")->Arg(1)->Arg(64)->Arg(4096);
+
+// Loads generated warmup orders into a fresh engine with one insert() per
+// order (bulk:0) or one bulk_insert() per 64k chunk (bulk:1).
+void BM_EngineLoad(benchmark::State &state) {
+  fm::GeneratorConfig config;
+  config.total_orders = static_cast<std::size_t>(state.range(0));
+  config.warmup_orders = config.total_orders;
+  config.symbol_count = static_cast<std::size_t>(state.range(1));
+  const bool bulk = state.range(2) != 0;
+  std::vector<Order> orders;
+  fm::OrderGenerator(config).for_each_batch([&](std::span<const Order> batch) {
+    orders.insert(orders.end(), batch.begin(), batch.end());
+    return true;
+  });
+  const TscClock &clock = TscClock::instance();
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    MatchingEngine engine;
+    std::uint64_t start = clock.start();
+    if (bulk) {
+      for (std::size_t i = 0; i < orders.size(); i += fm::OrderGenerator::kBatchSize) {
+        engine.bulk_insert(std::span<const Order>(orders).subspan(
+            i, std::min(fm::OrderGenerator::kBatchSize, orders.size() - i)));
+      }
+    } else {
+      for (const Order &order : orders) {
+        engine.insert(order);
+      }
+    }
+    record_ns(state, clock, start);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EngineLoad)
+    ->ArgNames({"orders", "symbols", "bulk"})
+    ->ArgsProduct({{1 << 20}, {4, 1000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+
+// A buy for half of a best ask level of `per_level` orders of mixed size,
+// under each allocation policy. The level is rebuilt untimed each iteration.
+template <typename Book>
+void BM_LevelAllocation(benchmark::State &state) {
+  const std::int64_t per_level = state.range(0);
+  const TscClock &clock = TscClock::instance();
+  std::uint64_t id = 0;
+  std::uint64_t level_quantity = 0;
+  for (std::int64_t i = 0; i < per_level; ++i) {
+    level_quantity += 10 + static_cast<std::uint64_t>(i % 7) * 10;
+  }
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    Book book;
+    for (std::int64_t i = 0; i < per_level; ++i) {
+      book.insertOrder(
+          make_order(++id, Side::SELL, ask_price(0), 10 + static_cast<std::uint64_t>(i % 7) * 10));
+    }
+    Order order = make_order(++id, Side::BUY, ask_price(0), level_quantity / 2, OrderType::IOC);
+    std::uint64_t start = clock.start();
+    benchmark::DoNotOptimize(book.match(order));
+    record_ns(state, clock, start);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_LevelAllocation, fm::OrderBook)
+    ->ArgName("per_level")->Arg(1)->Arg(16)->Arg(128)->Arg(1024)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_LevelAllocation, fm::ProRataOrderBook)
+    ->ArgName("per_level")->Arg(1)->Arg(16)->Arg(128)->Arg(1024)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_LevelAllocation, fm::TopOrderProRataOrderBook)
+    ->ArgName("per_level")->Arg(1)->Arg(16)->Arg(128)->Arg(1024)->UseManualTime();
+
+// Looks up symbols in random order, as a multi-instrument feed would. The
+// baseline is std::unordered_map with a transparent hash; SymbolMap is
+// measured with the hash computed per lookup and with the hash cached in
+// the order.
+std::vector<std::string> lookup_symbols(std::int64_t count) {
+  std::vector<std::string> symbols;
+  for (std::int64_t s = 0; s < count; ++s) {
+    symbols.push_back("SYM" + std::to_string(s));
+  }
+  return symbols;
+}
+
+std::vector<std::uint32_t> lookup_sequence(std::size_t symbols) {
+  std::mt19937_64 rng(1);
+  std::vector<std::uint32_t> sequence(1 << 16);
+  for (auto &index : sequence) {
+    index = static_cast<std::uint32_t>(rng() % symbols);
+  }
+  return sequence;
+}
+
+void BM_SymbolLookupUnorderedMap(benchmark::State &state) {
+  std::vector<std::string> symbols = lookup_symbols(state.range(0));
+  std::unordered_map<std::string, std::uint64_t, fm::SymbolHash, std::equal_to<>> map;
+  for (const std::string &symbol : symbols) {
+    map.emplace(symbol, 0);
+  }
+  std::vector<std::uint32_t> sequence = lookup_sequence(symbols.size());
+  std::size_t next = 0;
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    std::string_view symbol = symbols[sequence[next]];
+    benchmark::DoNotOptimize(++map.find(symbol)->second);
+    next = (next + 1) & (sequence.size() - 1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SymbolLookupUnorderedMap)->ArgName("symbols")->Arg(10)->Arg(1000)->Arg(100000);
+
+void BM_SymbolLookup(benchmark::State &state) {
+  const bool cached_hash = state.range(1) != 0;
+  std::vector<std::string> symbols = lookup_symbols(state.range(0));
+  std::vector<std::uint64_t> hashes;
+  fm::SymbolMap<std::uint64_t> map;
+  for (const std::string &symbol : symbols) {
+    hashes.push_back(fm::symbol_hash(symbol));
+    map.try_emplace(symbol, hashes.back(), 0);
+  }
+  std::vector<std::uint32_t> sequence = lookup_sequence(symbols.size());
+  std::size_t next = 0;
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    std::uint32_t index = sequence[next];
+    std::uint64_t hash = cached_hash ? hashes[index] : fm::symbol_hash(symbols[index]);
+    benchmark::DoNotOptimize(++*map.find(symbols[index], hash));
+    next = (next + 1) & (sequence.size() - 1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SymbolLookup)
+    ->ArgNames({"symbols", "cached_hash"})
+    ->ArgsProduct({{10, 1000, 100000}, {0, 1}});
+
+// Single-threaded push + pop of one order.
+void BM_QueuePushPop(benchmark::State &state) {
+  lfq::Atomic_Queue<Order> queue(static_cast<std::uint64_t>(state.range(0)));
+  Order order = make_order(1, Side::BUY, bid_price(0), 10);
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    queue.push(order);
+    benchmark::DoNotOptimize(queue.pop());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueuePushPop)->ArgName("capacity")->Arg(1024)->Arg(1 << 16);
+
+// Fill the queue to `burst` entries, then drain it.
+void BM_QueueBurst(benchmark::State &state) {
+  const std::int64_t burst = state.range(0);
+  lfq::Atomic_Queue<Order> queue(static_cast<std::uint64_t>(burst));
+  Order order = make_order(1, Side::BUY, bid_price(0), 10);
+  ScopedPerfCounters perf(state);
+  for (auto _ : state) {
+    for (std::int64_t i = 0; i < burst; ++i) {
+      queue.push(order);
+    }
+    for (std::int64_t i = 0; i < burst; ++i) {
+      benchmark::DoNotOptimize(queue.pop());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * burst);
+}
+BENCHMARK(BM_QueueBurst)->ArgName("burst")->Arg(64)->Arg(4096);
+
+} // namespace
+
+BENCHMARK_MAIN();
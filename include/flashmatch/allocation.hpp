@@ -0,0 +1,139 @@
+#ifndef FLASHMATCH_ALLOCATION_HPP
+#define FLASHMATCH_ALLOCATION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "types/order.hpp"
+
+namespace fm {
+
+// Orders resting at one price, oldest first.
+struct PriceLevel {
+  std::deque<Order> orders;
+  // The front order created this level at a new best price and has not
+  // been filled out yet. Only maintained for policies with kTopOrder.
+  bool top_order_live = false;
+};
+
+// How an incoming order's quantity is shared among the orders at a level.
+// Each policy is a BasicOrderBook template argument; allocate() fills up to
+// `quantity` from level through fill(resting, traded) and removes the orders
+// it fills out.
+
+// Strict price-time priority.
+struct FifoAllocation {
+  static constexpr bool kTopOrder = false;
+
+  template <typename Fill>
+  void allocate(PriceLevel &level, std::uint64_t quantity, Fill &fill) {
+    auto &orders = level.orders;
+    while (quantity > 0 && !orders.empty()) {
+      Order &resting = orders.front();
+      std::uint64_t traded = std::min(quantity, resting.quantity);
+      fill(resting, traded);
+      quantity -= traded;
+      if (resting.quantity == 0) {
+        orders.pop_front();
+      }
+    }
+  }
+};
+
+// Splits `quantity` (less than `total`, the sum of sizes) in proportion to
+// sizes, rounding down, then hands the leftover lots out in time priority.
+// The proportional pass runs over contiguous arrays and vectorizes.
+void pro_rata_split(std::span<const std::uint64_t> sizes, std::uint64_t total,
+                    std::uint64_t quantity, std::span<std::uint64_t> shares);
+
+// Every order at the level gets a share proportional to its size.
+struct ProRataAllocation {
+  static constexpr bool kTopOrder = false;
+
+  template <typename Fill>
+  void allocate(PriceLevel &level, std::uint64_t quantity, Fill &fill) {
+    auto &orders = level.orders;
+    sizes_.resize(orders.size());
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+      sizes_[i] = orders[i].quantity;
+      total += sizes_[i];
+    }
+    if (quantity >= total) {
+      for (Order &resting : orders) {
+        fill(resting, resting.quantity);
+      }
+      orders.clear();
+      return;
+    }
+    shares_.resize(orders.size());
+    pro_rata_split(sizes_, total, quantity, shares_);
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+      if (shares_[i] > 0) {
+        fill(orders[i], shares_[i]);
+      }
+    }
+    std::erase_if(orders, [](const Order &resting) { return resting.quantity == 0; });
+  }
+
+private:
+  // Scratch space kept across calls.
+  std::vector<std::uint64_t> sizes_;
+  std::vector<std::uint64_t> shares_;
+};
+
+// The order that set a new best price fills first, then the rest of the
+// level shares pro rata.
+struct TopOrderProRataAllocation {
+  static constexpr bool kTopOrder = true;
+
+  template <typename Fill>
+  void allocate(PriceLevel &level, std::uint64_t quantity, Fill &fill) {
+    if (level.top_order_live) {
+      Order &top = level.orders.front();
+      std::uint64_t traded = std::min(quantity, top.quantity);
+      fill(top, traded);
+      quantity -= traded;
+      if (top.quantity == 0) {
+        level.orders.pop_front();
+        level.top_order_live = false;
+      }
+    }
+    if (quantity > 0 && !level.orders.empty()) {
+      pro_rata_.allocate(level, quantity, fill);
+    }
+  }
+
+private:
+  ProRataAllocation pro_rata_;
+};
+
+enum class Allocation : std::uint8_t {
+  Fifo,
+  ProRata,
+  TopOrderProRata,
+};
+
+// "fifo", "pro_rata" or "top_order_pro_rata".
+const char *allocation_name(Allocation allocation);
+// False if name is not one of the above.
+bool parse_allocation(std::string_view name, Allocation &out);
+
+// Chooses each symbol's allocation when the engine creates its book.
+struct AllocationRules {
+  Allocation fallback = Allocation::Fifo;
+  // Checked in order; the first prefix the symbol starts with wins.
+  std::vector<std::pair<std::string, Allocation>> prefixes;
+
+  Allocation for_symbol(std::string_view symbol) const;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_ALLOCATION_HPP
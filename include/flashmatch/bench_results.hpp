@@ -0,0 +1,66 @@
+#ifndef FLASHMATCH_BENCH_RESULTS_HPP
+#define FLASHMATCH_BENCH_RESULTS_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "flashmatch/benchmark.hpp"
+
+namespace fm {
+
+// One benchmark run as written to a JSON lines or CSV results file.
+struct BenchRecord {
+  std::string timestamp;
+  std::string source;
+  std::string mode;
+  int run = 0;
+  BenchStats stats;
+  BenchEnvironment environment;
+};
+
+void write_record_json(std::ostream &out, const BenchRecord &record);
+void write_record_csv_header(std::ostream &out);
+void write_record_csv(std::ostream &out, const BenchRecord &record);
+// Reads a JSON lines file written by write_record_json. Lines that do not
+// parse are skipped; a missing file yields no records.
+std::vector<BenchRecord> read_records_json(const std::string &path);
+
+enum class Verdict { Unchanged, Improved, Regressed };
+
+// One metric compared between two sets of repeated runs.
+struct MetricDelta {
+  std::string metric;
+  // Medians across each set of runs.
+  double baseline = 0.0;
+  double current = 0.0;
+  // (current - baseline) / baseline, in percent.
+  double delta_pct = 0.0;
+  // How large |delta_pct| had to be to count; see CompareOptions.
+  double threshold_pct = 0.0;
+  Verdict verdict = Verdict::Unchanged;
+};
+
+struct CompareOptions {
+  // Deltas below this are never flagged.
+  double min_delta_pct = 5.0;
+  // A delta must also exceed this multiple of the run-to-run noise, taken
+  // as the larger relative half-range ((max - min) / 2 / median) of the two
+  // sets. With a single run per set only min_delta_pct applies.
+  double noise_multiplier = 2.0;
+};
+
+// Compares latency percentiles (p50 to p99.99 and mean), throughput and any
+// per-order hardware counters present in both sets. The single worst sample
+// is reported by output_stats but not compared; it is not a stable statistic.
+std::vector<MetricDelta> compare_records(const std::vector<BenchRecord> &baseline,
+                                         const std::vector<BenchRecord> &current,
+                                         const CompareOptions &options = {});
+bool has_regression(const std::vector<MetricDelta> &deltas);
+void output_comparison(const std::vector<MetricDelta> &deltas, std::size_t baseline_runs,
+                       std::size_t current_runs);
+
+} // namespace fm
+
+#endif // FLASHMATCH_BENCH_RESULTS_HPP
@@ -2,10 +2,18 @@
 #define FLASHMATCH_BENCHMARK_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
 
+#include "flashmatch/allocation.hpp"
+#include "flashmatch/perf_counters.hpp"
+
 namespace fm {
 
+struct GeneratorConfig;
+class LatencyHistogram;
+
 struct BenchStats {
   std::size_t total_orders = 0;
   std::size_t warmup_orders = 0;
@@ -14,13 +22,96 @@ struct BenchStats {
   double p50_latency = 0.0;
   double p95_latency = 0.0;
   double p99_latency = 0.0;
+  double p999_latency = 0.0;
+  double p9999_latency = 0.0;
+  double p99999_latency = 0.0;
   double worst_latency_us = 0.0;
   double total_time_us = 0.0;
+  // Engine time spent loading the warmup orders.
+  double warmup_time_us = 0.0;
+  // Per-order latency clock, from TscClock::describe().
+  std::string timer;
+  // Hardware counters over engine work in each phase, when requested.
+  PerfCounts warmup_counters;
+  PerfCounts bench_counters;
+  // Why counters are partly or wholly missing.
+  std::string perf_note;
+  // Group commits of the measured orders' journal, when one is written.
+  std::uint64_t journal_syncs = 0;
+};
+
+enum class BatchMode {
+  // add() each order, then one run().
+  Run,
+  // add() each order, then one run_grouped().
+  Grouped,
+  // One submit_batch() over all of them.
+  SubmitBatch,
+};
+
+struct BenchOptions {
+  // Overrides the dataset header's warmup row count.
+  std::optional<std::size_t> warmup_rows;
+  // Collect PerfCounters for the warmup and measured phases.
+  bool perf_counters = false;
+  // Dump the flight recorder once when a submit() takes longer than this
+  // (0 = never), to "<spike_dump_prefix>.0.fr".
+  std::uint64_t spike_dump_ns = 0;
+  std::string spike_dump_prefix = "flashmatch_spike";
+  // What run_batch_bench times over the measured orders.
+  BatchMode batch_mode = BatchMode::Run;
+  // Allocation policy of every symbol's book.
+  Allocation allocation = Allocation::Fifo;
+  // Threads building books from each warmup batch; 0 = one per CPU.
+  std::size_t load_threads = 1;
+  // Journal every measured order to this file before submit() (empty = no
+  // journal); the append is inside the timed region. Per-order modes only.
+  std::string journal_path;
 };
 
-BenchStats run_bench(const std::string &filename);
+// Parse-only throughput of the baseline row parser against CsvOrderScanner
+// over the same mapped dataset.
+struct ParseStats {
+  std::size_t bytes = 0;
+  std::size_t rows = 0;
+  double baseline_time_us = 0.0;
+  double simd_time_us = 0.0;
+  bool results_match = false;
+};
+
+// Where a result came from, for comparing runs across machines and builds.
+struct BenchEnvironment {
+  std::string cpu_model;
+  std::string compiler;
+  std::string compile_flags;
+  std::string git_revision;
+  std::string host;
+  std::string kernel;
+};
+
+// Per-order submit() latency.
+BenchStats run_bench(const std::string &filename, const BenchOptions &options = {});
+// Queues every measured order with add() and times a single run(); no
+// per-order latencies are filled in.
+BenchStats run_batch_bench(const std::string &filename, const BenchOptions &options = {});
 double run_engine_bench(const std::string &filename);
+// Same measurements over in-process generated order flow; no dataset file.
+BenchStats run_bench(const GeneratorConfig &config, const BenchOptions &options = {});
+BenchStats run_batch_bench(const GeneratorConfig &config, const BenchOptions &options = {});
+double run_engine_bench(const GeneratorConfig &config);
+ParseStats run_parse_bench(const std::string &filename);
+// Fills the latency fields of stats from nanosecond samples.
+void fill_latency_stats(const LatencyHistogram &latencies, BenchStats &stats);
 void output_stats(const BenchStats &stats);
+// The per-order counter table printed by output_stats.
+void output_perf_counts(const BenchStats &stats);
+void output_parse_stats(const ParseStats &stats);
+
+// CPU model from /proc/cpuinfo, host and kernel, plus the compiler, flags
+// and git revision of this build.
+BenchEnvironment bench_environment();
+// Pins the calling thread to one CPU. Returns false if the kernel refuses.
+bool pin_thread_to_cpu(int cpu);
 
 } // namespace fm
 
@@ -0,0 +1,104 @@
+#ifndef FLASHMATCH_BINARY_DATASET_HPP
+#define FLASHMATCH_BINARY_DATASET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "types/order.hpp"
+
+namespace fm {
+
+struct DatasetHeader;
+
+// Binary dataset layout (native little-endian):
+//   BinaryDatasetHeader
+//   symbol table: symbol_count entries of [u16 length][bytes], zero-padded
+//                 to symbol_table_bytes (a multiple of 8)
+//   record_count PackedOrder records
+inline constexpr char kBinaryDatasetMagic[8] = {'F', 'M', 'O', 'R', 'D', 'E', 'R', 'S'};
+inline constexpr std::uint32_t kBinaryDatasetVersion = 1;
+
+struct BinaryDatasetHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t symbol_count;
+  // Same meaning as the "total,warmup" line of a CSV dataset.
+  std::uint64_t total_rows;
+  std::uint64_t warmup_rows;
+  std::uint64_t record_count;
+  std::uint64_t symbol_table_bytes;
+};
+static_assert(sizeof(BinaryDatasetHeader) == 48);
+
+struct PackedOrder {
+  std::uint64_t id;
+  double price;
+  std::uint64_t quantity;
+  std::uint32_t symbol; // Index into the symbol table.
+  std::uint8_t side;    // Side as its underlying value.
+  std::uint8_t type;    // OrderType as its underlying value.
+  std::uint16_t reserved;
+};
+static_assert(sizeof(PackedOrder) == 32);
+
+bool is_binary_dataset(std::string_view data);
+
+// Zero-copy view of a mapped binary dataset.
+class BinaryDatasetView {
+public:
+  // Validates the header and symbol table. Returns false if data is not a
+  // well-formed binary dataset of the supported version.
+  bool open(std::string_view data);
+
+  const BinaryDatasetHeader &header() const { return header_; }
+  const std::vector<std::string> &symbols() const { return symbols_; }
+  std::span<const PackedOrder> records() const { return records_; }
+
+  // Expands a record into an Order, reusing out's symbol storage.
+  bool unpack(const PackedOrder &record, Order &out) const;
+
+private:
+  BinaryDatasetHeader header_{};
+  std::vector<std::string> symbols_;
+  std::vector<std::uint64_t> symbol_hashes_;
+  std::span<const PackedOrder> records_;
+};
+
+// Streams orders into a binary dataset. The symbol table is written up front,
+// so every symbol must be known when the writer is created.
+class BinaryDatasetWriter {
+public:
+  BinaryDatasetWriter(const std::string &path,
+                      const DatasetHeader &header,
+                      std::vector<std::string> symbols);
+
+  bool is_open() const { return out_.is_open() && out_.good(); }
+  // Returns false for a symbol that is not in the table.
+  bool append(const Order &order);
+  // Flushes buffered records and patches the record count into the header.
+  bool finish();
+
+private:
+  bool flush();
+
+  std::ofstream out_;
+  BinaryDatasetHeader header_{};
+  std::unordered_map<std::string, std::uint32_t> index_;
+  std::vector<PackedOrder> buffer_;
+};
+
+// Converts a CSV dataset to the binary format. Reads the CSV twice: once to
+// collect the symbol table and once to write the records.
+bool convert_csv_to_binary(const std::string &csv_path,
+                           const std::string &bin_path,
+                           std::size_t threads = 0);
+
+} // namespace fm
+
+#endif // FLASHMATCH_BINARY_DATASET_HPP
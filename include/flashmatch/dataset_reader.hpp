@@ -0,0 +1,86 @@
+#ifndef FLASHMATCH_DATASET_READER_HPP
+#define FLASHMATCH_DATASET_READER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flashmatch/binary_dataset.hpp"
+#include "flashmatch/mapped_file.hpp"
+#include "types/order.hpp"
+
+namespace fm {
+
+// The "total,warmup" counts every dataset starts with. The first warmup_rows
+// orders are resting LIMIT orders used to build the book before measuring.
+struct DatasetHeader {
+  std::size_t total_rows = 0;
+  std::size_t warmup_rows = 0;
+};
+
+bool parse_dataset_header(std::string_view line, DatasetHeader &out);
+
+// Row encodings accepted after the header line.
+enum class RowFormat { Csv, JsonLines };
+
+// JSON lines when the first non-blank byte after the header is '{'.
+RowFormat detect_row_format(std::string_view body);
+
+// Parses every row of text into orders[0, count), reusing existing elements
+// and growing the vector as needed. Returns false on a malformed row, which
+// is copied to error_line; the rows before it are still in orders.
+bool parse_rows(std::string_view text,
+                RowFormat format,
+                std::vector<Order> &orders,
+                std::size_t &count,
+                std::string &error_line);
+
+// Receives parsed orders one chunk at a time, in file order. Returning false
+// stops the reader early.
+using OrderBatchSink = std::function<bool(std::span<const Order>)>;
+
+class DatasetReader {
+public:
+  // Target size of the newline-aligned chunks handed to each parser.
+  static constexpr std::size_t kChunkBytes = std::size_t{4} << 20;
+
+  // threads == 0 uses one parser per hardware thread.
+  explicit DatasetReader(const std::string &path,
+                         std::size_t threads = 0,
+                         std::size_t chunk_bytes = kChunkBytes);
+
+  bool is_open() const { return open_; }
+  const DatasetHeader &header() const { return header_; }
+  // The offending row after for_each_batch() returned false.
+  const std::string &error_line() const { return error_line_; }
+
+  // Hands every order after the header to sink in file order. CSV and JSON
+  // lines rows are parsed on the thread pool; binary datasets (see binary_dataset.hpp) are
+  // detected by their magic and unpacked without parsing, and gzip-compressed
+  // text is inflated on a background thread (see gzip_dataset.hpp). Returns
+  // false if a row failed to parse.
+  bool for_each_batch(const OrderBatchSink &sink);
+
+private:
+  bool parse_chunks(const OrderBatchSink &sink);
+  bool read_binary(const OrderBatchSink &sink);
+
+  MappedFile file_;
+  DatasetHeader header_;
+  std::string_view body_;
+  RowFormat format_ = RowFormat::Csv;
+  BinaryDatasetView binary_;
+  bool is_binary_ = false;
+  bool is_gzip_ = false;
+  std::size_t threads_;
+  std::size_t chunk_bytes_;
+  std::string error_line_;
+  bool open_ = false;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_DATASET_READER_HPP
@@ -0,0 +1,162 @@
+#ifndef FLASHMATCH_FLIGHT_RECORDER_HPP
+#define FLASHMATCH_FLIGHT_RECORDER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flashmatch/tsc_clock.hpp"
+#include "types/order.hpp"
+
+namespace fm {
+
+enum class FlightEventType : std::uint8_t {
+  OrderReceived,
+  // Matching finished, after any rest: quantity filled, other_id = trades.
+  Matched,
+  // Added to the book, by insertOrder or as a match remainder.
+  Rested,
+  // One fill: order_id aggressor, other_id resting order.
+  Trade,
+  LevelCreated,
+  LevelErased,
+};
+
+// e.g. "RECV", "TRADE", "LEVEL+".
+const char *flight_event_name(FlightEventType type);
+
+// One cache line per event, so a record is a single aligned 64-byte store.
+struct alignas(64) FlightEvent {
+  std::uint64_t tsc;
+  std::uint64_t order_id;
+  std::uint64_t other_id;
+  double price;
+  std::uint64_t quantity;
+  char symbol[16];
+  FlightEventType type;
+  std::uint8_t side;
+  std::uint8_t order_type;
+  std::uint8_t reserved[5];
+};
+static_assert(sizeof(FlightEvent) == 64);
+
+// Per-thread ring of the most recent events. The owning thread overwrites
+// the oldest entry on wrap; a dump reads it without stopping the writer, so
+// the few events being written at that instant may be torn.
+struct FlightRing {
+  static constexpr std::size_t kEvents = 16384; // 1 MiB
+  std::atomic<std::uint64_t> head{0};
+  std::atomic<bool> in_use{false};
+  int thread_id = 0;
+  // Timestamp given to new events; see FlightRecorder::stamp().
+  std::uint64_t stamp = 0;
+  const TscClock *clock = &TscClock::instance();
+  std::unique_ptr<FlightEvent[]> events{new FlightEvent[kEvents]};
+};
+
+// Always-on flight recorder for OrderBook::match. record() is one 64-byte
+// store into the calling thread's ring. Reading the TSC costs more than the
+// store (about 20 ns under some hypervisors), so events carry the time of
+// the last stamp(); OrderBook stamps when a match starts and ends and on
+// direct inserts. Rings can be dumped on a signal
+// (install_flight_recorder_signal), from code that sees a latency spike
+// (SpikeDumper), or at any time with dump_flight_recorder(); `flight_decode`
+// prints a dump.
+class FlightRecorder {
+public:
+  static constexpr std::size_t kMaxRings = 256;
+
+  static void stamp() {
+    if (FlightRing *ring = local()) {
+      ring->stamp = ring->clock->now();
+    }
+  }
+
+  static void record(FlightEventType type, const Order &order, std::uint64_t quantity,
+                     double price, std::uint64_t other_id = 0) {
+    FlightRing *ring = local();
+    if (ring == nullptr) {
+      return;
+    }
+    std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    FlightEvent event{};
+    event.tsc = ring->stamp;
+    event.order_id = order.id;
+    event.other_id = other_id;
+    event.price = price;
+    event.quantity = quantity;
+    std::memcpy(event.symbol, order.symbol.data(),
+                std::min(order.symbol.size(), sizeof(event.symbol)));
+    event.type = type;
+    event.side = static_cast<std::uint8_t>(order.side);
+    event.order_type = static_cast<std::uint8_t>(order.type);
+    ring->events[head & (FlightRing::kEvents - 1)] = event;
+    ring->head.store(head + 1, std::memory_order_release);
+  }
+
+private:
+  friend struct RingReleaser;
+
+  static FlightRing *local() {
+    FlightRing *ring = local_ring_;
+    return ring != nullptr ? ring : attach_thread();
+  }
+  // Claims a ring for the calling thread; null once kMaxRings threads hold one.
+  static FlightRing *attach_thread();
+
+  inline static thread_local FlightRing *local_ring_ = nullptr;
+};
+
+// Writes every ring to fd. Async-signal-safe: no locks or allocation.
+bool dump_flight_recorder(int fd);
+bool dump_flight_recorder(const std::string &path);
+
+// Dumps to path on signo (SIGUSR2 by default), overwriting the previous dump.
+bool install_flight_recorder_signal(const std::string &path, int signo = 0);
+
+// Dumps the rings to "<prefix>.<n>.fr" the first max_dumps times a latency
+// passed to check() exceeds threshold_ns.
+class SpikeDumper {
+public:
+  SpikeDumper(std::string prefix, std::uint64_t threshold_ns, int max_dumps = 1)
+      : prefix_(std::move(prefix)), threshold_ns_(threshold_ns), max_dumps_(max_dumps) {}
+
+  void check(std::uint64_t latency_ns) {
+    if (latency_ns > threshold_ns_ && dumps_ < max_dumps_) {
+      dump(latency_ns);
+    }
+  }
+  int dumps() const { return dumps_; }
+
+private:
+  void dump(std::uint64_t latency_ns);
+
+  std::string prefix_;
+  std::uint64_t threshold_ns_;
+  int max_dumps_;
+  int dumps_ = 0;
+};
+
+// A dump read back for decoding.
+struct FlightDump {
+  double ns_per_tick = 1.0;
+  struct Thread {
+    int thread_id = 0;
+    // Oldest first.
+    std::vector<FlightEvent> events;
+  };
+  std::vector<Thread> threads;
+};
+
+// Returns false (and prints why) if path is not a flight recorder dump.
+bool read_flight_dump(const std::string &path, FlightDump &out);
+
+} // namespace fm
+
+#endif // FLASHMATCH_FLIGHT_RECORDER_HPP
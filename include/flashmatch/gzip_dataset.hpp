@@ -0,0 +1,39 @@
+#ifndef FLASHMATCH_GZIP_DATASET_HPP
+#define FLASHMATCH_GZIP_DATASET_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "flashmatch/dataset_reader.hpp"
+
+namespace fm {
+
+bool is_gzip_dataset(std::string_view data);
+
+// Reads a gzip-compressed CSV or JSON lines dataset. A background thread
+// inflates and parses fixed-size blocks and hands them to the caller through
+// a lock-free queue, so decompression overlaps with whatever the sink does.
+class GzipOrderStream {
+public:
+  // Number of parsed blocks the decompression thread may run ahead.
+  static constexpr std::size_t kBlocksInFlight = 4;
+  // Decompressed bytes per block.
+  static constexpr std::size_t kBlockBytes = std::size_t{4} << 20;
+
+  explicit GzipOrderStream(std::string_view compressed) : compressed_(compressed) {}
+
+  // Inflates just enough of the stream to parse the "total,warmup" line.
+  bool read_header(DatasetHeader &out) const;
+
+  // Streams every order after the header to sink in file order. Returns false
+  // on a malformed row or corrupt stream, with the reason in error_line.
+  bool for_each_batch(const OrderBatchSink &sink, std::string &error_line) const;
+
+private:
+  std::string_view compressed_;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_GZIP_DATASET_HPP
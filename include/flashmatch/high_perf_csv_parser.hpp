@@ -0,0 +1,63 @@
+#ifndef FLASHMATCH_HIGH_PERF_CSV_PARSER_HPP
+#define FLASHMATCH_HIGH_PERF_CSV_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "types/order.hpp"
+
+namespace fm {
+
+// Bit i is set when byte i of a 32-byte block is a ',' or a '\n'.
+struct DelimiterMask {
+  std::uint32_t commas;
+  std::uint32_t newlines;
+};
+
+// Classifies the 32 bytes starting at p. Uses AVX2 or a pair of 128-bit
+// compares when the library is built for them, and a scalar loop otherwise.
+DelimiterMask classify_block(const char *p);
+
+// Name of the classification kernel selected at build time.
+const char *csv_kernel_name();
+
+// Parses a plain decimal such as "9.87" or "-12.5" as a fixed-point mantissa
+// and scale, then converts with a single correctly rounded division. Needs
+// no NUL terminator and ignores the locale. Exponents and overlong mantissas
+// fall back to std::from_chars.
+bool parse_price(std::string_view text, double &out);
+
+// Parses one "id,symbol,side,price,quantity,type" row without its newline.
+bool parse_order_line(std::string_view line, Order &out);
+
+// Walks a buffer of newline-separated order rows, locating delimiters 32
+// bytes at a time instead of searching for each comma separately.
+class CsvOrderScanner {
+public:
+  CsvOrderScanner(const char *begin, const char *end);
+
+  // Parses the next row into out. Returns false at end of input or on a
+  // malformed row; failed() tells the two apart.
+  bool next(Order &out);
+
+  bool failed() const { return failed_; }
+  // The row most recently handed to next(), for error messages.
+  std::string_view last_line() const { return line_; }
+  const char *position() const { return cursor_; }
+
+private:
+  const char *next_delimiter();
+  void load_block();
+
+  const char *cursor_;
+  const char *end_;
+  const char *block_;
+  std::uint32_t mask_ = 0;
+  std::string_view line_;
+  bool failed_ = false;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_HIGH_PERF_CSV_PARSER_HPP
@@ -0,0 +1,181 @@
+#ifndef FLASHMATCH_JOURNAL_HPP
+#define FLASHMATCH_JOURNAL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "lock_free_queue/lock_free_queue.hpp"
+#include "types/order.hpp"
+
+namespace fm {
+
+// Journal layout (native little-endian):
+//   JournalHeader
+//   JournalRecord, then symbol_length symbol bytes zero-padded to a
+//   multiple of 8, once per order, sequences consecutive
+// Records reach the file a group commit at a time, and none of a group is
+// acked until its sync returns, so a crash can leave any unsynced tail:
+// part of a record, zeros, or garbage. Readers stop at the first record
+// whose checksum or sequence does not match; JournalReader::torn_tail()
+// tells such a tail from corruption of records that were synced.
+inline constexpr char kJournalMagic[8] = {'F', 'M', 'J', 'O', 'U', 'R', 'N', 'L'};
+inline constexpr std::uint32_t kJournalVersion = 1;
+
+struct JournalHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(JournalHeader) == 16);
+
+struct JournalRecord {
+  // MatchingEngine::sequence() once this order has been applied.
+  std::uint64_t sequence;
+  std::uint64_t id;
+  double price;
+  std::uint64_t quantity;
+  std::uint16_t symbol_length;
+  std::uint8_t side; // Side as its underlying value.
+  std::uint8_t type; // OrderType as its underlying value.
+  // zlib CRC-32 of this record with crc32 = 0, then the symbol bytes.
+  std::uint32_t crc32;
+};
+static_assert(sizeof(JournalRecord) == 40);
+
+// Reads the records of a mapped journal in order.
+class JournalReader {
+public:
+  // Returns false if data does not start with a journal header of the
+  // supported version.
+  bool open(std::string_view data);
+
+  // Decodes the next record into out, reusing its symbol storage. Returns
+  // false at the end of the journal or at a torn or corrupt record.
+  bool next(std::uint64_t &sequence, Order &out);
+  // Moves past the intact records from here on without decoding them, as
+  // repeated next() calls would. Returns how many there were.
+  std::size_t verify();
+  // Moves past the records up to and including sequence, reading only
+  // their headers. Returns how many were skipped.
+  std::size_t skip_through(std::uint64_t sequence);
+  // Bytes up to the end of the last record read or skipped (or the header).
+  std::size_t offset() const { return offset_; }
+  // Sequence of the last record read or skipped, 0 before the first.
+  std::uint64_t last_sequence() const { return last_sequence_; }
+  // Whether next() has stopped at the end of the data rather than at a
+  // damaged record.
+  bool at_end() const { return offset_ == data_.size(); }
+  // Whether the data next() stopped at is an unsynced tail left by a crash:
+  // no intact record with a later sequence lies anywhere past offset(). One
+  // that does means records that were synced, and maybe acked, are damaged.
+  bool torn_tail() const;
+
+private:
+  // Size of the record at offset if it is intact and, unless previous is
+  // 0, has sequence previous + 1; 0 otherwise. Fills record either way.
+  std::size_t intact_size(std::size_t offset, std::uint64_t previous,
+                          JournalRecord &record) const;
+
+  std::string_view data_;
+  std::size_t offset_ = 0;
+  std::uint64_t last_sequence_ = 0;
+};
+
+struct JournalOptions {
+  // A group commit is written and synced once this many orders (at least
+  // 1) are waiting, or once the oldest has waited group_commit_interval,
+  // whichever is first.
+  std::size_t group_commit_orders = 512;
+  std::chrono::microseconds group_commit_interval{200};
+  // Orders append() can queue ahead of the journal thread.
+  std::size_t queue_capacity = 1 << 16;
+  // Called on the journal thread after every sync with the new
+  // durable_sequence(); acks up to it may be released.
+  std::function<void(std::uint64_t)> on_durable;
+};
+
+// Write-ahead journal of sequenced inbound orders. The matching thread
+// append()s each order to a lock-free queue; a journal thread drains it,
+// encodes the records, and writes and fdatasync()s them a group at a time.
+// append() makes no system calls. An order's ack must wait until
+// durable_sequence() reaches its sequence.
+class Journal {
+public:
+  // Opens path for appending, creating it if needed. last_sequence is the
+  // sequence of the last order already applied (MatchingEngine::sequence());
+  // an existing journal must end at it, and an unsynced tail after it is
+  // truncated away. A journal whose synced records are damaged is not
+  // opened. The first append() gets last_sequence + 1.
+  Journal(const std::string &path, std::uint64_t last_sequence, JournalOptions options = {});
+  // Syncs everything appended, then stops the journal thread.
+  ~Journal();
+  Journal(const Journal &) = delete;
+  Journal &operator=(const Journal &) = delete;
+
+  // False if the file could not be opened, is damaged or does not match
+  // last_sequence; see error().
+  bool ok() const { return error_.empty(); }
+  const std::string &error() const { return error_; }
+
+  // Queues order and returns its sequence. Spins while the queue is full.
+  // Returns 0 if the journal is not ok(), a write has failed, or the
+  // symbol is too long for a record (more than 65535 bytes); such an order
+  // must not be applied.
+  std::uint64_t append(const Order &order) {
+    if (!running_ || failed_.load(std::memory_order_relaxed) ||
+        order.symbol.size() > std::numeric_limits<std::uint16_t>::max()) {
+      return 0;
+    }
+    while (!queue_.push(order)) {
+      if (failed_.load(std::memory_order_relaxed)) {
+        return 0;
+      }
+    }
+    return ++last_sequence_;
+  }
+
+  // Every order up to this sequence is on stable storage.
+  std::uint64_t durable_sequence() const { return durable_.load(std::memory_order_acquire); }
+  // Blocks until durable_sequence() reaches sequence. Returns false if the
+  // journal failed first.
+  bool wait_durable(std::uint64_t sequence) const;
+  // A write or sync failed; nothing appended since is durable.
+  bool failed() const { return failed_.load(std::memory_order_acquire); }
+  // Group commits (fdatasync calls) so far.
+  std::uint64_t syncs() const { return syncs_.load(std::memory_order_relaxed); }
+
+private:
+  void loop();
+  bool commit();
+
+  JournalOptions options_;
+  std::string error_;
+  int fd_ = -1;
+  bool running_ = false;
+  // Producer side: the sequence handed out by the last append().
+  std::uint64_t last_sequence_ = 0;
+  lfq::Atomic_Queue<Order> queue_;
+
+  // Journal thread state.
+  std::uint64_t encoded_sequence_ = 0;
+  std::size_t waiting_ = 0;
+  std::vector<char> buffer_;
+
+  std::atomic<std::uint64_t> durable_{0};
+  std::atomic<std::uint64_t> syncs_{0};
+  std::atomic<bool> failed_{false};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_JOURNAL_HPP
@@ -0,0 +1,52 @@
+#ifndef FLASHMATCH_JSONL_ORDER_PARSER_HPP
+#define FLASHMATCH_JSONL_ORDER_PARSER_HPP
+
+#include <string>
+#include <string_view>
+
+#include "types/order.hpp"
+
+namespace fm {
+
+// Walks a buffer of JSON order objects as written by generate_orderbook.py
+// with file_format == "json":
+//   {"id":1,"symbol":"AAPL","side":"BUY","price":9.87,"quantity":42,"type":"LIMIT"}
+// Values are parsed in place against this fixed schema; no DOM is built.
+// Keys may come in any order and unknown scalar keys are skipped. The
+// scanner accepts any whitespace within and between objects, but dataset
+// readers split their input into chunks at newlines, so a dataset must hold
+// exactly one object per line (JSON lines); an object spanning lines fails
+// to parse.
+class JsonOrderScanner {
+public:
+  JsonOrderScanner(const char *begin, const char *end) : cursor_(begin), end_(end) {}
+
+  // Parses the next object into out. Returns false at end of input or on a
+  // malformed object; failed() tells the two apart.
+  bool next(Order &out);
+
+  bool failed() const { return failed_; }
+  // The object most recently handed to next(), for error messages.
+  std::string_view last_line() const { return line_; }
+  const char *position() const { return cursor_; }
+
+private:
+  // Fast path for the exact key order and spacing pandas writes.
+  bool parse_canonical(Order &out);
+  bool parse_object(Order &out);
+  bool parse_string(std::string_view &out);
+  void skip_whitespace();
+
+  const char *cursor_;
+  const char *end_;
+  std::string_view line_;
+  std::string unescaped_;
+  bool failed_ = false;
+};
+
+// Parses one JSON order object.
+bool parse_order_json(std::string_view text, Order &out);
+
+} // namespace fm
+
+#endif // FLASHMATCH_JSONL_ORDER_PARSER_HPP
@@ -0,0 +1,65 @@
+#ifndef FLASHMATCH_LATENCY_HISTOGRAM_HPP
+#define FLASHMATCH_LATENCY_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fm {
+
+// HDR-style histogram of integer latencies (the benchmarks record
+// nanoseconds). Each power of two is split into 2^kSubBucketBits linear
+// buckets, so any recorded value is reported within 1/128 of its true value
+// across the whole 64-bit range, in a fixed ~58 KiB of counters. Recording is
+// a bit scan and an increment; histograms filled on different threads are
+// combined with merge().
+class LatencyHistogram {
+public:
+  static constexpr unsigned kSubBucketBits = 7;
+  static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+  static constexpr std::size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram() : counts_(kBucketCount, 0) {}
+
+  void record(std::uint64_t value) {
+    ++counts_[bucket_index(value)];
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void merge(const LatencyHistogram &other);
+  void reset();
+
+  std::uint64_t count() const { return count_; }
+  std::uint64_t min() const { return count_ == 0 ? 0 : min_; }
+  std::uint64_t max() const { return max_; }
+  double mean() const;
+  // Smallest recorded value v such that at least percent% of all values are
+  // <= v, reported as the top of v's bucket (clamped to max()). 0 if empty.
+  std::uint64_t percentile(double percent) const;
+
+  static std::size_t bucket_index(std::uint64_t value) {
+    if (value < kSubBuckets) {
+      return static_cast<std::size_t>(value);
+    }
+    const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + static_cast<std::size_t>((value >> shift) - kSubBuckets);
+  }
+  // Largest value that maps to bucket index.
+  static std::uint64_t bucket_upper_bound(std::size_t index);
+
+private:
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_ = 0;
+  std::uint64_t min_ = UINT64_MAX;
+  std::uint64_t max_ = 0;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,38 @@
+#ifndef FLASHMATCH_MAPPED_FILE_HPP
+#define FLASHMATCH_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace fm {
+
+// Read-only memory mapping of a whole file. The mapping is released when the
+// object is destroyed; a failed open leaves is_open() false.
+class MappedFile {
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  bool is_open() const { return open_; }
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  std::string_view view() const { return {data_, size_}; }
+
+private:
+  void release();
+
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  bool open_ = false;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_MAPPED_FILE_HPP
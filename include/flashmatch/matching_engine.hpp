@@ -1,34 +1,114 @@
 #ifndef FLASHMATCH_MATCHING_ENGINE_HPP
 #define FLASHMATCH_MATCHING_ENGINE_HPP
 
-
-#include <queue>
-
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include "flashmatch/order_book.hpp"
+#include "flashmatch/symbol_map.hpp"
 
 namespace fm {
 
+// Receives the trades of each order processed by submit_batch.
+class TradeSink {
+public:
+  virtual ~TradeSink() = default;
+  // Called once per order that traded; `trades` is only valid during the call.
+  virtual void on_trades(const Order &order, std::span<const Trade> trades) = 0;
+};
+
+// A book of any allocation policy. The engine dispatches with std::visit
+// once per order, or once per symbol run in run_grouped() and
+// submit_batch(); the matching loop itself has no indirect calls.
+using AnyOrderBook = std::variant<OrderBook, ProRataOrderBook, TopOrderProRataOrderBook>;
+
 class MatchingEngine {
 public:
-  MatchingEngine() = default;
+  // rules picks each symbol's allocation policy when its book is created.
+  explicit MatchingEngine(AllocationRules rules = {}) : rules_(std::move(rules)) {}
 
   // Insert an order without triggering any matching.
   void insert(const Order &order);
+  // insert() for each order in turn, building each book in one pass. For
+  // loading resting orders (warmup, snapshots); call it once per chunk for
+  // large loads. With threads > 1 (0 = one per hardware thread) symbols are
+  // spread over that many threads, each book filled by exactly one; the
+  // call returns once every book is complete.
+  void bulk_insert(std::span<const Order> orders, std::size_t threads = 1);
   // Queue an order for later processing.
   void add(const Order &order);
+  void add(Order &&order);
   // Process all queued orders and return the trades executed.
   std::vector<Trade> run();
+  // Process all queued orders one symbol at a time: each symbol's orders run
+  // back to back, in arrival order, against a single book lookup. Every
+  // book ends in the same state as after run(), but trades are grouped by
+  // symbol instead of interleaved in arrival order. For replay and
+  // backtesting, where the interleaving across symbols does not matter.
+  std::vector<Trade> run_grouped();
   // Immediately process an order and return the trades executed.
 
   std::vector<Trade> submit(const Order &order);
+  // Immediately process orders in sequence, as submit() would, handing each
+  // order's trades to sink without building a vector per order.
+  void submit_batch(std::span<const Order> orders, TradeSink &sink);
+
+  // The book for symbol, or null if no order for it has been seen.
+  const AnyOrderBook *find_book(std::string_view symbol) const { return books_.find(symbol); }
+  std::size_t book_count() const { return books_.size(); }
+  // Orders applied so far by insert(), bulk_insert(), run(), run_grouped(),
+  // submit() and submit_batch(); restored by load_snapshot().
+  std::uint64_t sequence() const { return sequence_; }
+
+  // Writes every book's resting orders, allocation policy and sequence() to
+  // path (see snapshot.hpp), replacing it atomically once the data is
+  // synced. Orders queued by add() are not included.
+  bool save_snapshot(const std::string &path) const;
+  // Restores a save_snapshot() file into an engine that has no books yet,
+  // mapping the file and filling books on up to `threads` threads as
+  // bulk_insert() does. Returns false, leaving the engine empty, if the
+  // file is missing, corrupt or of another version.
+  bool load_snapshot(const std::string &path, std::size_t threads = 1);
 
 private:
-  std::unordered_map<std::string, OrderBook> books_;
-  std::queue<Order> pending_;
+  // The book for order's symbol, created with metrics gauges on first use.
+  // Uses order.symbol_hash when the producer has filled it in. A miss with
+  // that hash is retried with a fresh one, so a stale hash left in a copied
+  // Order cannot create a second book for its symbol.
+  AnyOrderBook &book(const Order &order) {
+    std::uint64_t hash = order.symbol_hash;
+    if (hash != 0) {
+      if (AnyOrderBook *found = books_.find(order.symbol, hash)) {
+        return *found;
+      }
+    }
+    hash = symbol_hash(order.symbol);
+    if (AnyOrderBook *found = books_.find(order.symbol, hash)) {
+      return *found;
+    }
+    return new_book(order.symbol, hash, rules_.for_symbol(order.symbol));
+  }
+  AnyOrderBook &new_book(std::string_view symbol, std::uint64_t hash, Allocation allocation);
+  // Calls fn(i) for each i in [0, sizes.size()) on up to `threads` threads
+  // (0 = one per hardware thread), largest sizes[i] first.
+  static void for_each_parallel(std::span<const std::size_t> sizes, std::size_t threads,
+                                const std::function<void(std::size_t)> &fn);
+
+  AllocationRules rules_;
+  SymbolMap<AnyOrderBook> books_;
+  // Queued by add(); cleared, keeping its capacity, by run().
+  std::vector<Order> pending_;
+  // Scratch space kept across calls: run_grouped()'s sorted orders and
+  // submit_batch()'s trades for the current order.
+  std::vector<Order> grouped_;
+  std::vector<Trade> batch_trades_;
+  std::uint64_t sequence_ = 0;
 };
 
 } // namespace fm
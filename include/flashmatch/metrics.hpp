@@ -0,0 +1,180 @@
+#ifndef FLASHMATCH_METRICS_HPP
+#define FLASHMATCH_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fm {
+
+enum class Counter : std::size_t {
+  OrdersIn,
+  TradesOut,
+  IocRemaindersDropped,
+  QueuePushes,
+  QueuePushFailures,
+};
+inline constexpr std::size_t kCounterCount = 5;
+
+// e.g. "orders_in", "queue_push_failures".
+const char *counter_name(Counter counter);
+
+// One thread's counters, on its own cache line. Only the owning thread
+// writes, with a relaxed load + store rather than a locked add; the reader
+// sums every slot.
+struct alignas(64) CounterSlot {
+  std::array<std::atomic<std::uint64_t>, kCounterCount> values{};
+};
+
+// Live size of one order book, published by the thread that owns the book.
+struct alignas(64) BookGauges {
+  std::atomic<std::int64_t> levels{0};
+  std::atomic<std::int64_t> orders{0};
+  std::string symbol;
+  bool in_use = false;
+};
+
+class MetricsRegistry;
+
+struct BookGaugesRelease {
+  MetricsRegistry *registry = nullptr;
+  void operator()(BookGauges *gauges) const;
+};
+using BookGaugesHandle = std::unique_ptr<BookGauges, BookGaugesRelease>;
+
+struct SymbolMetrics {
+  std::string symbol;
+  std::int64_t levels = 0;
+  std::int64_t orders = 0;
+};
+
+// Totals across all threads at one instant. Counters only ever grow;
+// gauges are the latest published values.
+struct MetricsSnapshot {
+  std::chrono::system_clock::time_point time;
+  std::array<std::uint64_t, kCounterCount> counters{};
+  // Summed over every book with the same symbol, sorted by symbol.
+  std::vector<SymbolMetrics> symbols;
+  // Sampled from add_gauge() callbacks, e.g. queue depth.
+  std::vector<std::pair<std::string, std::int64_t>> gauges;
+
+  std::uint64_t operator[](Counter counter) const {
+    return counters[static_cast<std::size_t>(counter)];
+  }
+};
+
+// Process-wide telemetry. Hot paths call add(), which touches only the
+// calling thread's CounterSlot; books publish their sizes through a
+// BookGaugesHandle. Only registration and snapshot() take the lock.
+//
+//   MetricsRegistry::add(Counter::OrdersIn);
+//   MetricsSnapshot now = MetricsRegistry::instance().snapshot();
+class MetricsRegistry {
+public:
+  MetricsRegistry() = default;
+  MetricsRegistry(const MetricsRegistry &) = delete;
+  MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+  static MetricsRegistry &instance();
+
+  static void add(Counter counter, std::uint64_t n = 1) {
+    CounterSlot *slot = local_slot_;
+    if (slot == nullptr) {
+      slot = instance().attach_thread();
+    }
+    auto &value = slot->values[static_cast<std::size_t>(counter)];
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  // Gauges for one book of `symbol`; released (and zeroed) with the handle.
+  BookGaugesHandle register_book(std::string_view symbol);
+
+  // A value sampled on every snapshot, called on the snapshotting thread.
+  // Returns an id for remove_gauge().
+  std::size_t add_gauge(std::string name, std::function<std::int64_t()> sample);
+  void remove_gauge(std::size_t id);
+
+  MetricsSnapshot snapshot() const;
+
+private:
+  friend struct BookGaugesRelease;
+  friend struct SlotReleaser;
+
+  CounterSlot *attach_thread();
+  void release(CounterSlot *slot);
+  void release(BookGauges *gauges);
+
+  inline static thread_local CounterSlot *local_slot_ = nullptr;
+
+  mutable std::mutex mutex_;
+  // Deques keep slot addresses stable. Slots of exited threads keep their
+  // totals and are handed to the next new thread.
+  std::deque<CounterSlot> slots_;
+  std::vector<CounterSlot *> free_slots_;
+  std::deque<BookGauges> books_;
+  std::vector<BookGauges *> free_books_;
+  struct Gauge {
+    std::size_t id;
+    std::string name;
+    std::function<std::int64_t()> sample;
+  };
+  std::vector<Gauge> gauges_;
+  std::size_t next_gauge_id_ = 0;
+};
+
+// Prometheus text exposition format, also readable by node_exporter's
+// textfile collector.
+void write_prometheus(std::ostream &out, const MetricsSnapshot &snapshot);
+
+struct ExporterOptions {
+  std::chrono::milliseconds interval{1000};
+  // Rewritten (via rename) with every snapshot; empty to disable.
+  std::string text_path;
+  // Serves GET /metrics on 127.0.0.1; 0 picks a free port, -1 disables.
+  int http_port = -1;
+};
+
+// Reader thread that snapshots a registry every interval and exports it.
+class MetricsExporter {
+public:
+  explicit MetricsExporter(ExporterOptions options,
+                           MetricsRegistry &registry = MetricsRegistry::instance());
+  ~MetricsExporter();
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+  // False if the HTTP port could not be opened; see error().
+  bool ok() const { return error_.empty(); }
+  const std::string &error() const { return error_; }
+  // The bound HTTP port, or -1.
+  int port() const { return port_; }
+
+private:
+  void loop();
+  void export_file(const std::string &text) const;
+  void serve(int client) const;
+
+  ExporterOptions options_;
+  MetricsRegistry &registry_;
+  std::string error_;
+  int listen_fd_ = -1;
+  int port_ = -1;
+  int wake_fds_[2] = {-1, -1};
+  std::thread thread_;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_METRICS_HPP
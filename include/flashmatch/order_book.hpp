@@ -2,25 +2,110 @@
 #include <deque>
 #include <functional>
 #include <map>
+#include <span>
 #include <vector>
 #include <types/order.hpp>
 #include <types/trade.hpp>
 #include <types/side.hpp>
 #include <types/ordertype.hpp> // Include necessary headers
+#include "flashmatch/allocation.hpp"
+#include "flashmatch/metrics.hpp"
 
 namespace fm {
-class OrderBook {
+
+// Compile-time description of one side of the book. Compare orders that
+// side's levels best first; an incoming order crosses a resting level on
+// the opposite side unless the opposite side's Compare puts its limit
+// strictly ahead of the level's price.
+template <Side S> struct SideTraits;
+
+template <> struct SideTraits<Side::BUY> {
+  using Compare = std::greater<double>; // Highest bid first.
+  static constexpr Side opposite = Side::SELL;
+};
+
+template <> struct SideTraits<Side::SELL> {
+  using Compare = std::less<double>; // Lowest ask first.
+  static constexpr Side opposite = Side::BUY;
+};
+
+// A price-priority book whose levels share fills according to Allocation
+// (see allocation.hpp). Member definitions live in order_book.cpp, which
+// instantiates every policy.
+template <typename Allocation>
+class BasicOrderBook {
 private:
-  using OrderDeque = std::deque<Order>;
-  std::map<double, OrderDeque, std::greater<double>> bids_;
-  std::map<double, OrderDeque, std::less<double>> asks_;
+  template <Side S>
+  using Levels = std::map<double, PriceLevel, typename SideTraits<S>::Compare>;
+
+  Levels<Side::BUY> bids_;
+  Levels<Side::SELL> asks_;
+  std::int64_t live_orders_ = 0;
+  // Null unless attached by the engine.
+  BookGaugesHandle gauges_;
+  [[no_unique_address]] Allocation allocation_;
+
+  template <Side S> Levels<S> &levels() {
+    if constexpr (S == Side::BUY) {
+      return bids_;
+    } else {
+      return asks_;
+    }
+  }
+
+  // Appends to the level at order.price on side S, creating it if needed.
+  template <Side S> void rest(const Order &order);
+  // bulk_insert() for one side's orders, given in arrival order.
+  template <Side S> void bulk_rest(std::vector<const Order *> &orders);
+  // The matching kernel for an order of side S and type T: sweeps the
+  // opposite side, then rests (LIMIT) or drops (IOC) the remainder.
+  template <Side S, OrderType T> void match_kernel(Order &order, std::vector<Trade> &trades);
+  // Stores the current level and order counts into gauges_.
+  void publish() {
+    if (gauges_) {
+      gauges_->levels.store(static_cast<std::int64_t>(bids_.size() + asks_.size()),
+                            std::memory_order_relaxed);
+      gauges_->orders.store(live_orders_, std::memory_order_relaxed);
+    }
+  }
 
 public:
-  OrderBook() = default;
+  BasicOrderBook() = default;
   // Process incoming order and process trades executed.
   std::vector<Trade> match(Order order);
+  // Same, appending the trades to `trades`.
+  void match(Order order, std::vector<Trade> &trades);
   // Insert a limit order without matching.
   void insertOrder(const Order &order);
+  // insertOrder() for each order in turn, in one pass per side: orders are
+  // stable-sorted by price and appended level by level, so the book ends
+  // exactly as after sequential inserts. Records no flight recorder events.
+  void bulk_insert(std::span<const Order> orders);
+  // Publish live level and order counts to the metrics registry.
+  void attach_metrics(BookGaugesHandle gauges);
+
+  // Calls fn(side, price, level) for every level, bids then asks, each side
+  // best price first. For snapshots.
+  template <typename Fn> void for_each_level(Fn &&fn) const {
+    for (const auto &[price, level] : bids_) {
+      fn(Side::BUY, price, level);
+    }
+    for (const auto &[price, level] : asks_) {
+      fn(Side::SELL, price, level);
+    }
+  }
+  // Adds a level behind every existing level on its side, as when restoring
+  // for_each_level() output in order. Returns false, leaving the book
+  // unchanged, if price is not strictly worse than the side's worst level.
+  bool append_level(Side side, double price, PriceLevel level);
 };
 
+extern template class BasicOrderBook<FifoAllocation>;
+extern template class BasicOrderBook<ProRataAllocation>;
+extern template class BasicOrderBook<TopOrderProRataAllocation>;
+
+using OrderBook = BasicOrderBook<FifoAllocation>;
+using ProRataOrderBook = BasicOrderBook<ProRataAllocation>;
+using TopOrderProRataOrderBook = BasicOrderBook<TopOrderProRataAllocation>;
+
 } // namespace fm
@@ -0,0 +1,88 @@
+#ifndef FLASHMATCH_ORDER_GENERATOR_HPP
+#define FLASHMATCH_ORDER_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flashmatch/dataset_reader.hpp"
+#include "lock_free_queue/lock_free_queue.hpp"
+#include "types/order.hpp"
+
+namespace fm {
+
+struct GeneratorConfig {
+  // Same meaning as a dataset's "total,warmup" header. Warmup orders are
+  // LIMIT only, like generate_orderbook.py.
+  std::size_t total_orders = 120'000'000;
+  std::size_t warmup_orders = 20'000'000;
+  std::uint64_t seed = 42;
+  std::size_t symbol_count = 4;
+  // Every symbol's mid starts here and random-walks one tick at a time.
+  double initial_mid = 10.0;
+  double tick_size = 0.01;
+  // Probability that an order moves its symbol's mid by one tick.
+  double mid_move_probability = 0.05;
+  // Limit prices are uniform within this many ticks either side of the mid,
+  // so roughly half of the orders cross the spread.
+  std::uint32_t price_range_ticks = 50;
+  std::uint64_t min_quantity = 1;
+  std::uint64_t max_quantity = 100;
+  // Share of post-warmup orders sent as IOC.
+  double ioc_ratio = 0.5;
+};
+
+// Deterministic synthetic order flow. The same config always yields the same
+// orders on every platform: the RNG is xoshiro256** and all distributions are
+// computed here rather than taken from <random>.
+class OrderGenerator {
+public:
+  explicit OrderGenerator(const GeneratorConfig &config = {});
+
+  const GeneratorConfig &config() const { return config_; }
+  const DatasetHeader &header() const { return header_; }
+  const std::vector<std::string> &symbols() const { return symbols_; }
+
+  // Restarts the stream from the first order.
+  void reset();
+  // Writes the next order of the stream into out, reusing its symbol storage.
+  void next(Order &out);
+
+  // Restarts the stream and hands all total_orders orders to sink in batches,
+  // mirroring DatasetReader::for_each_batch. Always returns true.
+  bool for_each_batch(const OrderBatchSink &sink);
+
+  // Pushes the next count orders into queue, spinning while it is full.
+  void push_to(lfq::Atomic_Queue<Order> &queue, std::size_t count) {
+    Order order;
+    for (std::size_t i = 0; i < count; ++i) {
+      next(order);
+      while (!queue.push(order)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  static constexpr std::size_t kBatchSize = 1 << 16;
+
+private:
+  std::uint64_t next_u64();
+  // Uniform in [0, bound).
+  std::uint64_t next_below(std::uint64_t bound);
+  // Uniform in [0, 1).
+  double next_unit();
+
+  GeneratorConfig config_;
+  DatasetHeader header_;
+  std::vector<std::string> symbols_;
+  std::vector<std::uint64_t> symbol_hashes_;
+  std::vector<std::int64_t> mid_ticks_;
+  std::uint64_t state_[4];
+  std::uint64_t emitted_ = 0;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_ORDER_GENERATOR_HPP
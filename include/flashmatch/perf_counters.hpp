@@ -0,0 +1,75 @@
+#ifndef FLASHMATCH_PERF_COUNTERS_HPP
+#define FLASHMATCH_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fm {
+
+enum class PerfEvent : std::size_t {
+  Cycles,
+  Instructions,
+  L1dMisses,
+  LlcMisses,
+  BranchMisses,
+  DtlbMisses,
+};
+inline constexpr std::size_t kPerfEventCount = 6;
+
+// e.g. "cycles", "llc-misses".
+const char *perf_event_name(PerfEvent event);
+
+struct PerfCounts {
+  // Events that could not be opened are not present and read as 0.
+  std::array<bool, kPerfEventCount> present{};
+  std::array<std::uint64_t, kPerfEventCount> values{};
+
+  bool any() const;
+  bool has(PerfEvent event) const { return present[static_cast<std::size_t>(event)]; }
+  std::uint64_t operator[](PerfEvent event) const {
+    return values[static_cast<std::size_t>(event)];
+  }
+};
+
+// Hardware counters for the calling thread (user space only) via
+// perf_event_open. Events are opened as two groups, {cycles, instructions,
+// branch misses} and {L1D, LLC, dTLB read misses}, so each group fits the PMU
+// and its counts are mutually consistent; values are scaled up if the kernel
+// had to multiplex. Anything that cannot be opened (perf_event_paranoid,
+// containers, VMs without a virtual PMU) is left out and explained by
+// error(); the object is then a cheap no-op.
+class PerfCounters {
+public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  // True if at least one event is being counted.
+  bool available() const { return !groups_.empty(); }
+  // Why some or all events are missing; empty when all opened.
+  const std::string &error() const { return error_; }
+
+  // Counting accumulates across enable()/disable() pairs until reset().
+  void reset();
+  void enable();
+  void disable();
+  PerfCounts read() const;
+
+private:
+  struct Group {
+    int leader = -1;
+    std::vector<int> fds;
+    std::vector<PerfEvent> events;
+  };
+
+  std::vector<Group> groups_;
+  std::string error_;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_PERF_COUNTERS_HPP
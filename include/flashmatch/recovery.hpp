@@ -0,0 +1,47 @@
+#ifndef FLASHMATCH_RECOVERY_HPP
+#define FLASHMATCH_RECOVERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fm {
+
+class MatchingEngine;
+
+struct RecoveryStats {
+  // Engine sequence after loading the snapshot (0 without one).
+  std::uint64_t snapshot_sequence = 0;
+  // Journal records at or before snapshot_sequence, skipped unread.
+  std::uint64_t skipped = 0;
+  std::uint64_t replayed = 0;
+  // Trades produced by the replay; they were already reported before the
+  // crash, so they are only counted.
+  std::uint64_t trades = 0;
+  double snapshot_time_us = 0.0;
+  // Includes checking the whole journal before the snapshot is loaded.
+  double replay_time_us = 0.0;
+  // The journal ended in an unsynced tail left by the crash, which was
+  // ignored; none of it was acked.
+  bool torn_tail = false;
+};
+
+// Path of the *.snap file in directory with the highest sequence, or empty
+// if there is none.
+std::string latest_snapshot(const std::string &directory);
+
+// Rebuilds engine, which must have no books, from a snapshot and the
+// journal written since: loads snapshot_path (skipped if empty) on up to
+// `threads` threads, then submits every journal record after the
+// snapshot's sequence, in order, straight from the mapped journal.
+// journal_path may be empty to load the snapshot alone. Returns false
+// (and prints why) if either file is unusable, the journal does not
+// continue from the snapshot, or an intact record follows damage in it
+// (see JournalReader::torn_tail()). The journal is checked before the
+// engine is touched, so on failure it holds at most the snapshot.
+bool recover(MatchingEngine &engine, const std::string &snapshot_path,
+             const std::string &journal_path, RecoveryStats &stats, std::size_t threads = 1);
+
+} // namespace fm
+
+#endif // FLASHMATCH_RECOVERY_HPP
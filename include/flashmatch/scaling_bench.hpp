@@ -0,0 +1,56 @@
+#ifndef FLASHMATCH_SCALING_BENCH_HPP
+#define FLASHMATCH_SCALING_BENCH_HPP
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "flashmatch/benchmark.hpp"
+
+namespace fm {
+
+struct GeneratorConfig;
+
+// Result of running N independent engines concurrently.
+struct ScalingPoint {
+  std::size_t threads = 0;
+  // Measured orders across all threads.
+  std::size_t measured_orders = 0;
+  // From the first thread starting its measured phase to the last finishing.
+  double wall_time_us = 0.0;
+  double orders_per_sec = 0.0;
+  // submit() latency per thread, in thread order.
+  std::vector<BenchStats> per_thread;
+};
+
+struct ScalingOptions {
+  // Runs 1..max_threads engines; 0 means std::thread::hardware_concurrency().
+  // Capped, with a warning, at the number of symbols in the flow.
+  std::size_t max_threads = 0;
+  // Thread t is pinned to cpus[t % cpus.size()], or to CPU t if empty.
+  std::vector<int> cpus;
+  std::optional<std::size_t> warmup_rows;
+};
+
+// Loads the whole flow into memory, then for each N in 1..max_threads splits
+// it by symbol (symbols in order of first appearance, round-robin over
+// threads) and runs one MatchingEngine per thread on its pinned CPU. Each
+// thread copies its own shard, warms up, then all start the measured phase
+// together.
+std::vector<ScalingPoint> run_scaling_bench(const std::string &filename,
+                                            const ScalingOptions &options);
+std::vector<ScalingPoint> run_scaling_bench(const GeneratorConfig &config,
+                                            const ScalingOptions &options);
+
+// One row per N: aggregate throughput, speedup and efficiency against N=1,
+// and the worst thread's tail latencies.
+void output_scaling(const std::vector<ScalingPoint> &points);
+// One row per (N, thread), for plotting.
+void write_scaling_csv_header(std::ostream &out);
+void write_scaling_csv(std::ostream &out, const ScalingPoint &point);
+
+} // namespace fm
+
+#endif // FLASHMATCH_SCALING_BENCH_HPP
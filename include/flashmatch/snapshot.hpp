@@ -0,0 +1,62 @@
+#ifndef FLASHMATCH_SNAPSHOT_HPP
+#define FLASHMATCH_SNAPSHOT_HPP
+
+#include <cstdint>
+
+namespace fm {
+
+// Engine snapshot layout (native little-endian), written by
+// MatchingEngine::save_snapshot:
+//   SnapshotHeader
+//   symbol table: book_count entries of [u16 length][bytes], zero-padded to
+//                 symbol_table_bytes (a multiple of 8)
+//   book_count SnapshotBook records, in symbol table order
+//   level_count SnapshotLevel records: book by book, bids then asks, each
+//                 side best price first
+//   order_count SnapshotOrder records: level by level, oldest first
+// crc32 is the zlib CRC-32 of every byte after the header.
+inline constexpr char kSnapshotMagic[8] = {'F', 'M', 'S', 'N', 'A', 'P', 'S', 'H'};
+inline constexpr std::uint32_t kSnapshotVersion = 1;
+
+struct SnapshotHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t book_count;
+  // MatchingEngine::sequence() when the snapshot was taken.
+  std::uint64_t sequence;
+  std::uint64_t level_count;
+  std::uint64_t order_count;
+  std::uint64_t symbol_table_bytes;
+  std::uint32_t crc32;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(SnapshotHeader) == 56);
+
+struct SnapshotBook {
+  std::uint64_t level_count;
+  std::uint8_t allocation; // Allocation as its underlying value.
+  std::uint8_t reserved[7];
+};
+static_assert(sizeof(SnapshotBook) == 16);
+
+struct SnapshotLevel {
+  double price;
+  std::uint32_t order_count;
+  std::uint8_t side;           // Side as its underlying value.
+  std::uint8_t top_order_live; // PriceLevel::top_order_live.
+  std::uint16_t reserved;
+};
+static_assert(sizeof(SnapshotLevel) == 16);
+
+// Price, side and symbol come from the enclosing level and book.
+struct SnapshotOrder {
+  std::uint64_t id;
+  std::uint64_t quantity;
+  std::uint8_t type; // OrderType as its underlying value.
+  std::uint8_t reserved[7];
+};
+static_assert(sizeof(SnapshotOrder) == 24);
+
+} // namespace fm
+
+#endif // FLASHMATCH_SNAPSHOT_HPP
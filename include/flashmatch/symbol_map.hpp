@@ -0,0 +1,160 @@
+#ifndef FLASHMATCH_SYMBOL_MAP_HPP
+#define FLASHMATCH_SYMBOL_MAP_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fm {
+
+// 64-bit hash of a symbol, eight bytes at a time. Never 0, so Order can use
+// 0 for "not computed".
+inline std::uint64_t symbol_hash(std::string_view symbol) {
+  auto mix = [](std::uint64_t x) {
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    return x;
+  };
+  std::uint64_t h = 0x9e3779b97f4a7c15ULL ^ symbol.size();
+  std::size_t i = 0;
+  for (; i + 8 <= symbol.size(); i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, symbol.data() + i, 8);
+    h = mix(h ^ word) * 0x9e3779b97f4a7c15ULL;
+  }
+  if (i < symbol.size()) {
+    // A byte loop: memcpy of a variable length is a library call.
+    std::uint64_t word = 0;
+    for (std::size_t j = i; j < symbol.size(); ++j) {
+      word |= std::uint64_t{static_cast<unsigned char>(symbol[j])} << (8 * (j - i));
+    }
+    h = mix(h ^ word) * 0x9e3779b97f4a7c15ULL;
+  }
+  h = mix(h);
+  return h != 0 ? h : 1;
+}
+
+// Transparent hasher, so std::unordered_map<std::string, T, SymbolHash,
+// std::equal_to<>> can be searched with a string_view.
+struct SymbolHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view symbol) const { return symbol_hash(symbol); }
+};
+
+// Open-addressing (linear probing) map from symbol to V. The probe array
+// holds only 8-byte {hash tag, entry index} slots, so a lookup usually reads
+// one slot line plus the entry itself. Entries live in a deque: their
+// addresses never change, and they keep their hash so growing the table
+// never rehashes a string. There is no erase; books live as long as the
+// engine.
+template <typename V>
+class SymbolMap {
+public:
+  struct Entry {
+    std::string key;
+    std::uint64_t hash;
+    V value;
+  };
+
+  std::size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  // Sizes the table for n symbols without growing.
+  void reserve(std::size_t n) {
+    if (n * 2 > slots_.size()) {
+      rebuild(std::bit_ceil(n * 2));
+    }
+  }
+
+  V *find(std::string_view key, std::uint64_t hash) {
+    std::uint32_t index = lookup(key, hash);
+    return index != 0 ? &entries_[index - 1].value : nullptr;
+  }
+  const V *find(std::string_view key, std::uint64_t hash) const {
+    std::uint32_t index = lookup(key, hash);
+    return index != 0 ? &entries_[index - 1].value : nullptr;
+  }
+  V *find(std::string_view key) { return find(key, symbol_hash(key)); }
+  const V *find(std::string_view key) const { return find(key, symbol_hash(key)); }
+
+  // The value for key, constructed from args if key is new; second is true
+  // if it was inserted. hash must be symbol_hash(key).
+  template <typename... Args>
+  std::pair<V *, bool> try_emplace(std::string_view key, std::uint64_t hash, Args &&...args) {
+    if ((entries_.size() + 1) * 2 > slots_.size()) {
+      rebuild(slots_.empty() ? 16 : slots_.size() * 2);
+    }
+    const std::size_t mask = slots_.size() - 1;
+    const auto tag = static_cast<std::uint32_t>(hash >> 32);
+    for (std::size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+      Slot &slot = slots_[pos];
+      if (slot.index == 0) {
+        Entry &entry =
+            entries_.emplace_back(std::string(key), hash, V(std::forward<Args>(args)...));
+        slot = {tag, static_cast<std::uint32_t>(entries_.size())};
+        return {&entry.value, true};
+      }
+      if (slot.tag == tag && entries_[slot.index - 1].key == key) {
+        return {&entries_[slot.index - 1].value, false};
+      }
+    }
+  }
+
+  // Entries in insertion order.
+  auto begin() { return entries_.begin(); }
+  auto end() { return entries_.end(); }
+  auto begin() const { return entries_.begin(); }
+  auto end() const { return entries_.end(); }
+
+private:
+  struct Slot {
+    std::uint32_t tag = 0;   // High half of the hash.
+    std::uint32_t index = 0; // Entry index + 1; 0 marks an empty slot.
+  };
+
+  std::uint32_t lookup(std::string_view key, std::uint64_t hash) const {
+    if (slots_.empty()) {
+      return 0;
+    }
+    const std::size_t mask = slots_.size() - 1;
+    const auto tag = static_cast<std::uint32_t>(hash >> 32);
+    for (std::size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+      const Slot &slot = slots_[pos];
+      if (slot.index == 0) {
+        return 0;
+      }
+      if (slot.tag == tag && entries_[slot.index - 1].key == key) {
+        return slot.index;
+      }
+    }
+  }
+
+  void rebuild(std::size_t capacity) {
+    std::vector<Slot> slots(capacity);
+    const std::size_t mask = capacity - 1;
+    for (std::size_t i = 0; i < entries_.size(); ++i) {
+      std::uint64_t hash = entries_[i].hash;
+      std::size_t pos = hash & mask;
+      while (slots[pos].index != 0) {
+        pos = (pos + 1) & mask;
+      }
+      slots[pos] = {static_cast<std::uint32_t>(hash >> 32), static_cast<std::uint32_t>(i + 1)};
+    }
+    slots_ = std::move(slots);
+  }
+
+  // Power-of-two size, at most half full.
+  std::vector<Slot> slots_;
+  std::deque<Entry> entries_;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_SYMBOL_MAP_HPP
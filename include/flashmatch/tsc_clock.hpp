@@ -0,0 +1,99 @@
+#ifndef FLASHMATCH_TSC_CLOCK_HPP
+#define FLASHMATCH_TSC_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define FLASHMATCH_HAVE_RDTSC 1
+#else
+#define FLASHMATCH_HAVE_RDTSC 0
+#endif
+
+namespace fm {
+
+// Cheap interval timer for per-order latency. On x86 with an invariant TSC
+// (constant rate across P-states, synchronised across cores) start()/stop()
+// read the cycle counter directly, at a few ns each instead of the ~20 ns of
+// a vDSO steady_clock call; elsewhere they fall back to steady_clock
+// nanoseconds. Either way, subtract two readings and pass the difference to
+// to_ns().
+//
+//   const TscClock &clock = TscClock::instance();
+//   auto t0 = clock.start();
+//   work();
+//   std::uint64_t ns = clock.to_ns(clock.stop() - t0);
+class TscClock {
+public:
+  // Calibrates against steady_clock for about calibration_ms. use_tsc=false,
+  // or a CPU without an invariant TSC, selects the steady_clock fallback.
+  explicit TscClock(bool use_tsc = true, int calibration_ms = 20);
+
+  // Shared clock, calibrated on first use. FLASHMATCH_CLOCK=steady in the
+  // environment forces the fallback.
+  static const TscClock &instance();
+
+  // lfence keeps the read from being hoisted above earlier instructions.
+  std::uint64_t start() const {
+#if FLASHMATCH_HAVE_RDTSC
+    if (tsc_) {
+      _mm_lfence();
+      return __rdtsc();
+    }
+#endif
+    return steady_ns();
+  }
+
+  // rdtscp waits for the timed code to retire; the trailing lfence keeps
+  // later instructions from starting before the read.
+  std::uint64_t stop() const {
+#if FLASHMATCH_HAVE_RDTSC
+    if (tsc_) {
+      unsigned aux;
+      std::uint64_t ticks = __rdtscp(&aux);
+      _mm_lfence();
+      return ticks;
+    }
+#endif
+    return steady_ns();
+  }
+
+  // Unfenced read for event timestamps, where a few instructions of
+  // reordering do not matter.
+  std::uint64_t now() const {
+#if FLASHMATCH_HAVE_RDTSC
+    if (tsc_) {
+      return __rdtsc();
+    }
+#endif
+    return steady_ns();
+  }
+
+  std::uint64_t to_ns(std::uint64_t ticks) const {
+    return static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick_);
+  }
+
+  bool uses_tsc() const { return tsc_; }
+  double ns_per_tick() const { return ns_per_tick_; }
+  // e.g. "tsc (2.90 GHz)" or "steady_clock".
+  std::string describe() const;
+
+  // Whether this CPU advertises an invariant TSC (CPUID 0x80000007 EDX[8]).
+  static bool invariant_tsc_available();
+
+private:
+  static std::uint64_t steady_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch())
+                                          .count());
+  }
+
+  bool tsc_ = false;
+  double ns_per_tick_ = 1.0;
+};
+
+} // namespace fm
+
+#endif // FLASHMATCH_TSC_CLOCK_HPP
@@ -23,6 +23,9 @@ public:
   T pop();
   bool isEmpty() const;
   std::uint64_t size() const;
+  // Entries currently queued. Safe from any thread; exact only when
+  // neither end is moving.
+  std::uint64_t depth() const;
 };
 } // namespace lfq
 #include "lock_free_queue.ipp"
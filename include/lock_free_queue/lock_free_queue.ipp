@@ -44,3 +44,9 @@ template <typename T> T lfq::Atomic_Queue<T>::pop() {
 template <typename T> std::uint64_t lfq::Atomic_Queue<T>::size() const {
   return size_;
 }
+
+template <typename T> std::uint64_t lfq::Atomic_Queue<T>::depth() const {
+  auto h = head_.load(std::memory_order_acquire);
+  auto t = tail_.load(std::memory_order_acquire);
+  return (t + capacity_ - h) % capacity_;
+}
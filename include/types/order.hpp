@@ -15,6 +15,9 @@ struct Order {
   double price;
   std::uint64_t quantity;
   OrderType type;
+  // fm::symbol_hash(symbol), or 0 if not computed yet. A hint only: the
+  // engine recomputes it when it does not find the symbol's book.
+  std::uint64_t symbol_hash = 0;
 };
 
 #endif // TYPES_ORDER_HPP
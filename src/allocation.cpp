@@ -0,0 +1,60 @@
+#include "flashmatch/allocation.hpp"
+
+namespace fm {
+
+void pro_rata_split(std::span<const std::uint64_t> sizes, std::uint64_t total,
+                    std::uint64_t quantity, std::span<std::uint64_t> shares) {
+  const double ratio = static_cast<double>(quantity) / static_cast<double>(total);
+  const std::size_t n = sizes.size();
+  std::uint64_t allocated = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    shares[i] = static_cast<std::uint64_t>(static_cast<double>(sizes[i]) * ratio);
+    allocated += shares[i];
+  }
+  // Rounding can push a product up to the next integer; take any excess
+  // back from the newest orders.
+  for (std::size_t i = n; allocated > quantity && i-- > 0;) {
+    std::uint64_t excess = std::min(shares[i], allocated - quantity);
+    shares[i] -= excess;
+    allocated -= excess;
+  }
+  for (std::size_t i = 0; i < n && allocated < quantity; ++i) {
+    std::uint64_t extra = std::min(sizes[i] - shares[i], quantity - allocated);
+    shares[i] += extra;
+    allocated += extra;
+  }
+}
+
+const char *allocation_name(Allocation allocation) {
+  switch (allocation) {
+  case Allocation::Fifo:
+    return "fifo";
+  case Allocation::ProRata:
+    return "pro_rata";
+  case Allocation::TopOrderProRata:
+    return "top_order_pro_rata";
+  }
+  return "unknown";
+}
+
+bool parse_allocation(std::string_view name, Allocation &out) {
+  for (Allocation allocation :
+       {Allocation::Fifo, Allocation::ProRata, Allocation::TopOrderProRata}) {
+    if (name == allocation_name(allocation)) {
+      out = allocation;
+      return true;
+    }
+  }
+  return false;
+}
+
+Allocation AllocationRules::for_symbol(std::string_view symbol) const {
+  for (const auto &[prefix, allocation] : prefixes) {
+    if (symbol.starts_with(prefix)) {
+      return allocation;
+    }
+  }
+  return fallback;
+}
+
+} // namespace fm
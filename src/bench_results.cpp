@@ -0,0 +1,347 @@
+#include "flashmatch/bench_results.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+namespace fm {
+
+namespace {
+
+std::string json_escape(std::string_view text) {
+  std::string out;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out.push_back(' ');
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+std::string csv_field(std::string_view text) {
+  if (text.find_first_of(",\"\n") == std::string_view::npos) {
+    return std::string(text);
+  }
+  std::string out = "\"";
+  for (char c : text) {
+    if (c == '"') {
+      out.push_back('"');
+    }
+    out.push_back(c);
+  }
+  out.push_back('"');
+  return out;
+}
+
+double per_order(const PerfCounts &counts, PerfEvent event, std::size_t orders) {
+  return orders == 0 ? 0.0 : static_cast<double>(counts[event]) / static_cast<double>(orders);
+}
+
+double orders_per_sec(const BenchStats &stats) {
+  return stats.total_time_us > 0.0
+             ? static_cast<double>(stats.num_orders) * 1e6 / stats.total_time_us
+             : 0.0;
+}
+
+// Splits one flat JSON object of string and number values, as written by
+// write_record_json, into key/value pairs. String values are unescaped.
+bool parse_flat_json(std::string_view line,
+                     std::vector<std::pair<std::string, std::string>> &fields) {
+  std::size_t i = line.find('{');
+  if (i == std::string_view::npos) {
+    return false;
+  }
+  ++i;
+  auto read_string = [&](std::string &out) {
+    if (i >= line.size() || line[i] != '"') {
+      return false;
+    }
+    for (++i; i < line.size() && line[i] != '"'; ++i) {
+      if (line[i] == '\\' && i + 1 < line.size()) {
+        ++i;
+      }
+      out.push_back(line[i]);
+    }
+    return i++ < line.size();
+  };
+  while (i < line.size() && line[i] != '}') {
+    std::string key, value;
+    if (!read_string(key) || i >= line.size() || line[i++] != ':') {
+      return false;
+    }
+    if (i < line.size() && line[i] == '"') {
+      if (!read_string(value)) {
+        return false;
+      }
+    } else {
+      std::size_t end = line.find_first_of(",}", i);
+      if (end == std::string_view::npos) {
+        return false;
+      }
+      value = std::string(line.substr(i, end - i));
+      i = end;
+    }
+    fields.emplace_back(std::move(key), std::move(value));
+    if (i < line.size() && line[i] == ',') {
+      ++i;
+    }
+  }
+  return i < line.size();
+}
+
+double to_double(const std::string &text) {
+  double value = 0.0;
+  std::from_chars(text.data(), text.data() + text.size(), value);
+  return value;
+}
+
+struct Metric {
+  const char *name;
+  bool higher_is_better;
+  std::function<double(const BenchRecord &)> value;
+  // False when the metric was not measured for this record.
+  std::function<bool(const BenchRecord &)> present;
+};
+
+std::vector<Metric> metrics() {
+  auto always = [](const BenchRecord &) { return true; };
+  auto latency = [](const BenchRecord &r) { return r.stats.worst_latency_us > 0.0; };
+  std::vector<Metric> list = {
+      {"orders/s", true, [](const BenchRecord &r) { return orders_per_sec(r.stats); }, always},
+      {"mean us", false, [](const BenchRecord &r) { return r.stats.mean_latency; }, latency},
+      {"p50 us", false, [](const BenchRecord &r) { return r.stats.p50_latency; }, latency},
+      {"p95 us", false, [](const BenchRecord &r) { return r.stats.p95_latency; }, latency},
+      {"p99 us", false, [](const BenchRecord &r) { return r.stats.p99_latency; }, latency},
+      {"p99.9 us", false, [](const BenchRecord &r) { return r.stats.p999_latency; }, latency},
+      {"p99.99 us", false, [](const BenchRecord &r) { return r.stats.p9999_latency; }, latency},
+  };
+  for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+    auto event = static_cast<PerfEvent>(i);
+    list.push_back(
+        {perf_event_name(event), false,
+         [event](const BenchRecord &r) {
+           return per_order(r.stats.bench_counters, event, r.stats.num_orders);
+         },
+         [event](const BenchRecord &r) { return r.stats.bench_counters.has(event); }});
+  }
+  return list;
+}
+
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  std::size_t n = values.size();
+  return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+double relative_half_range(const std::vector<double> &values, double mid) {
+  if (values.size() < 2 || mid == 0.0) {
+    return 0.0;
+  }
+  auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+  return (*hi - *lo) / 2.0 / std::abs(mid);
+}
+
+} // namespace
+
+void write_record_json(std::ostream &out, const BenchRecord &record) {
+  const BenchStats &s = record.stats;
+  const BenchEnvironment &e = record.environment;
+  out << std::setprecision(6) << std::defaultfloat;
+  out << "{\"timestamp\":\"" << json_escape(record.timestamp) << "\",\"source\":\""
+      << json_escape(record.source) << "\",\"mode\":\"" << json_escape(record.mode)
+      << "\",\"run\":" << record.run << ",\"total_orders\":" << s.total_orders
+      << ",\"warmup_orders\":" << s.warmup_orders << ",\"num_orders\":" << s.num_orders
+      << ",\"mean_us\":" << s.mean_latency << ",\"p50_us\":" << s.p50_latency
+      << ",\"p95_us\":" << s.p95_latency << ",\"p99_us\":" << s.p99_latency
+      << ",\"p999_us\":" << s.p999_latency << ",\"p9999_us\":" << s.p9999_latency
+      << ",\"p99999_us\":" << s.p99999_latency << ",\"max_us\":" << s.worst_latency_us
+      << ",\"total_time_us\":" << s.total_time_us << ",\"warmup_time_us\":" << s.warmup_time_us
+      << ",\"orders_per_sec\":" << orders_per_sec(s);
+  for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+    auto event = static_cast<PerfEvent>(i);
+    if (s.bench_counters.has(event)) {
+      out << ",\"" << perf_event_name(event)
+          << "_per_order\":" << per_order(s.bench_counters, event, s.num_orders);
+    }
+  }
+  out << ",\"timer\":\"" << json_escape(s.timer) << "\",\"cpu\":\"" << json_escape(e.cpu_model)
+      << "\",\"host\":\"" << json_escape(e.host) << "\",\"kernel\":\"" << json_escape(e.kernel)
+      << "\",\"git\":\"" << json_escape(e.git_revision) << "\",\"compiler\":\""
+      << json_escape(e.compiler) << "\",\"flags\":\"" << json_escape(e.compile_flags)
+      << "\"}\n";
+}
+
+void write_record_csv_header(std::ostream &out) {
+  out << "timestamp,source,mode,run,total_orders,warmup_orders,num_orders,mean_us,p50_us,"
+         "p95_us,p99_us,p999_us,p9999_us,p99999_us,max_us,total_time_us,orders_per_sec";
+  for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+    out << ',' << perf_event_name(static_cast<PerfEvent>(i)) << "_per_order";
+  }
+  out << ",timer,cpu,host,kernel,git,compiler,flags\n";
+}
+
+void write_record_csv(std::ostream &out, const BenchRecord &record) {
+  const BenchStats &s = record.stats;
+  const BenchEnvironment &e = record.environment;
+  out << std::setprecision(6) << std::defaultfloat;
+  out << csv_field(record.timestamp) << ',' << csv_field(record.source) << ','
+      << csv_field(record.mode) << ',' << record.run << ',' << s.total_orders << ','
+      << s.warmup_orders << ',' << s.num_orders << ',' << s.mean_latency << ','
+      << s.p50_latency << ',' << s.p95_latency << ',' << s.p99_latency << ','
+      << s.p999_latency << ',' << s.p9999_latency << ',' << s.p99999_latency << ','
+      << s.worst_latency_us << ',' << s.total_time_us << ',' << orders_per_sec(s);
+  for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+    auto event = static_cast<PerfEvent>(i);
+    out << ',';
+    if (s.bench_counters.has(event)) {
+      out << per_order(s.bench_counters, event, s.num_orders);
+    }
+  }
+  out << ',' << csv_field(s.timer) << ',' << csv_field(e.cpu_model) << ',' << csv_field(e.host)
+      << ',' << csv_field(e.kernel) << ',' << csv_field(e.git_revision) << ','
+      << csv_field(e.compiler) << ',' << csv_field(e.compile_flags) << '\n';
+}
+
+std::vector<BenchRecord> read_records_json(const std::string &path) {
+  std::vector<BenchRecord> records;
+  std::ifstream in(path);
+  std::string line;
+  std::vector<std::pair<std::string, std::string>> fields;
+  while (std::getline(in, line)) {
+    fields.clear();
+    if (!parse_flat_json(line, fields)) {
+      continue;
+    }
+    BenchRecord r;
+    BenchStats &s = r.stats;
+    std::vector<std::pair<PerfEvent, double>> counters;
+    for (const auto &[key, value] : fields) {
+      if (key == "timestamp") r.timestamp = value;
+      else if (key == "source") r.source = value;
+      else if (key == "mode") r.mode = value;
+      else if (key == "run") r.run = static_cast<int>(to_double(value));
+      else if (key == "total_orders") s.total_orders = static_cast<std::size_t>(to_double(value));
+      else if (key == "warmup_orders") s.warmup_orders = static_cast<std::size_t>(to_double(value));
+      else if (key == "num_orders") s.num_orders = static_cast<std::size_t>(to_double(value));
+      else if (key == "mean_us") s.mean_latency = to_double(value);
+      else if (key == "p50_us") s.p50_latency = to_double(value);
+      else if (key == "p95_us") s.p95_latency = to_double(value);
+      else if (key == "p99_us") s.p99_latency = to_double(value);
+      else if (key == "p999_us") s.p999_latency = to_double(value);
+      else if (key == "p9999_us") s.p9999_latency = to_double(value);
+      else if (key == "p99999_us") s.p99999_latency = to_double(value);
+      else if (key == "max_us") s.worst_latency_us = to_double(value);
+      else if (key == "total_time_us") s.total_time_us = to_double(value);
+      else if (key == "warmup_time_us") s.warmup_time_us = to_double(value);
+      else if (key == "timer") s.timer = value;
+      else if (key == "cpu") r.environment.cpu_model = value;
+      else if (key == "host") r.environment.host = value;
+      else if (key == "kernel") r.environment.kernel = value;
+      else if (key == "git") r.environment.git_revision = value;
+      else if (key == "compiler") r.environment.compiler = value;
+      else if (key == "flags") r.environment.compile_flags = value;
+      else {
+        for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+          auto event = static_cast<PerfEvent>(i);
+          if (key == std::string(perf_event_name(event)) + "_per_order") {
+            counters.emplace_back(event, to_double(value));
+          }
+        }
+      }
+    }
+    // Counters are stored per order; rebuild the phase totals.
+    for (auto [event, value] : counters) {
+      auto index = static_cast<std::size_t>(event);
+      s.bench_counters.present[index] = true;
+      s.bench_counters.values[index] =
+          static_cast<std::uint64_t>(std::llround(value * static_cast<double>(s.num_orders)));
+    }
+    records.push_back(std::move(r));
+  }
+  return records;
+}
+
+std::vector<MetricDelta> compare_records(const std::vector<BenchRecord> &baseline,
+                                         const std::vector<BenchRecord> &current,
+                                         const CompareOptions &options) {
+  std::vector<MetricDelta> deltas;
+  if (baseline.empty() || current.empty()) {
+    return deltas;
+  }
+  for (const Metric &metric : metrics()) {
+    std::vector<double> base_values, current_values;
+    for (const BenchRecord &record : baseline) {
+      if (metric.present(record)) {
+        base_values.push_back(metric.value(record));
+      }
+    }
+    for (const BenchRecord &record : current) {
+      if (metric.present(record)) {
+        current_values.push_back(metric.value(record));
+      }
+    }
+    if (base_values.empty() || current_values.empty()) {
+      continue;
+    }
+    MetricDelta delta;
+    delta.metric = metric.name;
+    delta.baseline = median(base_values);
+    delta.current = median(current_values);
+    if (delta.baseline == 0.0) {
+      continue;
+    }
+    delta.delta_pct = (delta.current - delta.baseline) / delta.baseline * 100.0;
+    double noise = std::max(relative_half_range(base_values, delta.baseline),
+                            relative_half_range(current_values, delta.current));
+    delta.threshold_pct = std::max(options.min_delta_pct, options.noise_multiplier * noise * 100.0);
+    if (std::abs(delta.delta_pct) > delta.threshold_pct) {
+      bool worse = metric.higher_is_better ? delta.delta_pct < 0.0 : delta.delta_pct > 0.0;
+      delta.verdict = worse ? Verdict::Regressed : Verdict::Improved;
+    }
+    deltas.push_back(std::move(delta));
+  }
+  return deltas;
+}
+
+bool has_regression(const std::vector<MetricDelta> &deltas) {
+  return std::any_of(deltas.begin(), deltas.end(),
+                     [](const MetricDelta &d) { return d.verdict == Verdict::Regressed; });
+}
+
+void output_comparison(const std::vector<MetricDelta> &deltas, std::size_t baseline_runs,
+                       std::size_t current_runs) {
+  std::cout << "=== Flashmatch Baseline Comparison ===\n";
+  std::cout << "Runs:                  baseline " << baseline_runs << ", current " << current_runs
+            << "\n";
+  if (deltas.empty()) {
+    std::cout << "No comparable metrics" << std::endl;
+    return;
+  }
+  std::cout << std::left << std::setw(16) << "metric" << std::right << std::setw(14)
+            << "baseline" << std::setw(14) << "current" << std::setw(10) << "delta"
+            << std::setw(11) << "threshold" << "  verdict\n";
+  for (const MetricDelta &d : deltas) {
+    const char *verdict = d.verdict == Verdict::Regressed  ? "REGRESSED"
+                          : d.verdict == Verdict::Improved ? "improved"
+                                                           : "~";
+    std::cout << std::left << std::setw(16) << d.metric << std::right << std::setprecision(3)
+              << std::defaultfloat << std::setw(14) << d.baseline << std::setw(14) << d.current
+              << std::fixed << std::setprecision(1) << std::setw(9) << std::showpos
+              << d.delta_pct << "%" << std::noshowpos << "   ±" << std::setw(6)
+              << d.threshold_pct << "%  " << verdict << "\n";
+  }
+  std::cout << std::flush;
+}
+
+} // namespace fm
@@ -1,24 +1,53 @@
 #include "flashmatch/benchmark.hpp"
 
+#include <pthread.h>
+#include <sched.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <array>
 #include <charconv>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
-#include <numeric>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "flashmatch/dataset_reader.hpp"
+#include "flashmatch/flight_recorder.hpp"
+#include "flashmatch/high_perf_csv_parser.hpp"
+#include "flashmatch/journal.hpp"
+#include "flashmatch/latency_histogram.hpp"
+#include "flashmatch/mapped_file.hpp"
 #include "flashmatch/matching_engine.hpp"
+#include "flashmatch/order_generator.hpp"
+#include "flashmatch/perf_counters.hpp"
+#include "flashmatch/tsc_clock.hpp"
+
+// Set per target by CMake: the flags flashmatch_lib is built with and the
+// `git describe` of the tree at configure time.
+#ifndef FLASHMATCH_COMPILE_FLAGS
+#define FLASHMATCH_COMPILE_FLAGS "unknown"
+#endif
+#ifndef FLASHMATCH_GIT_REVISION
+#define FLASHMATCH_GIT_REVISION "unknown"
+#endif
 
 namespace fm {
 
 namespace {
 
-bool parse_order_line(std::string_view line, Order &out) {
+// The original find/atof row parser, kept as the run_parse_bench baseline.
+bool parse_order_line_baseline(std::string_view line, Order &out) {
   std::size_t start = 0, end = 0;
   std::array<std::string_view, 6> tokens;
 
@@ -34,6 +63,7 @@ bool parse_order_line(std::string_view line, Order &out) {
 
   std::from_chars(tokens[0].data(), tokens[0].data() + tokens[0].size(), out.id);
   out.symbol = std::string(tokens[1]);
+  out.symbol_hash = 0;
   out.side = (tokens[2] == "BUY") ? Side::BUY : Side::SELL;
   out.price = std::atof(tokens[3].data());
   std::from_chars(tokens[4].data(), tokens[4].data() + tokens[4].size(), out.quantity);
@@ -42,155 +72,432 @@ bool parse_order_line(std::string_view line, Order &out) {
   return true;
 }
 
-} // namespace
+std::uint64_t order_checksum(const Order &order) {
+  return order.id * 31 + order.quantity + static_cast<std::uint64_t>(order.price * 100.0) +
+         order.symbol.size() + static_cast<std::uint64_t>(order.side) +
+         static_cast<std::uint64_t>(order.type);
+}
 
-BenchStats run_bench(const std::string &filename) {
-  std::ifstream file(filename);
-  BenchStats stats{};
-  if (!file.is_open()) {
-    std::cout << "Failed to open file: " << filename << std::endl;
-    return stats;
+// Streams a DatasetReader or OrderGenerator in order, handing the first
+// warmup_rows orders to warmup and the remaining measured orders to bench.
+template <typename Source, typename WarmupFn, typename BenchFn>
+bool replay_dataset(Source &reader, std::size_t warmup_rows, WarmupFn &&warmup, BenchFn &&bench) {
+  const DatasetHeader &header = reader.header();
+  std::size_t warmup_left = std::min(warmup_rows, header.total_rows);
+  std::size_t bench_left = header.total_rows - warmup_left;
+  bool ok = reader.for_each_batch([&](std::span<const Order> batch) {
+    std::size_t n = std::min(warmup_left, batch.size());
+    if (n > 0) {
+      warmup(batch.first(n));
+      warmup_left -= n;
+      batch = batch.subspan(n);
+    }
+    n = std::min(bench_left, batch.size());
+    if (n > 0) {
+      bench(batch.first(n));
+      bench_left -= n;
+    }
+    return warmup_left + bench_left > 0;
+  });
+  if constexpr (requires { reader.error_line(); }) {
+    if (!ok) {
+      std::cout << "Failed to parse line: " << reader.error_line() << std::endl;
+    }
   }
+  return ok;
+}
 
-  std::string header_line;
-  if (!std::getline(file, header_line)) {
-    std::cout << "Error: missing header line" << std::endl;
-    return stats;
-  }
 
-  std::size_t total_rows = 0;
-  std::size_t warmup_rows = 0;
-  std::string_view header_sv(header_line);
-  auto comma = header_sv.find(',');
-  std::from_chars(header_sv.data(), header_sv.data() + comma, total_rows);
-  std::from_chars(header_sv.data() + comma + 1,
-                  header_sv.data() + header_sv.size(), warmup_rows);
+// Hardware counters for one replay, enabled only around engine work so that
+// parsing or generation on this thread is not counted. A no-op unless
+// BenchOptions::perf_counters is set.
+class PhaseCounters {
+public:
+  PhaseCounters(bool enabled, BenchStats &stats) : stats_(stats) {
+    if (enabled) {
+      counters_.emplace();
+      stats_.perf_note = counters_->error();
+      counters_->reset();
+    }
+  }
+  void resume() {
+    if (counters_) {
+      counters_->enable();
+    }
+  }
+  void pause() {
+    if (counters_) {
+      counters_->disable();
+    }
+  }
+  // Closes the warmup phase; later counts go to the measured phase.
+  void end_warmup() {
+    if (counters_ && !warmup_done_) {
+      stats_.warmup_counters = counters_->read();
+      counters_->reset();
+      warmup_done_ = true;
+    }
+  }
+  void finish() {
+    end_warmup();
+    if (counters_) {
+      stats_.bench_counters = counters_->read();
+    }
+  }
 
-  stats.total_orders = total_rows;
-  stats.warmup_orders = warmup_rows;
+private:
+  BenchStats &stats_;
+  std::optional<PerfCounters> counters_;
+  bool warmup_done_ = false;
+};
+
+template <typename Source>
+void init_stats(BenchStats &stats, Source &reader, const BenchOptions &options) {
+  stats.total_orders = reader.header().total_rows;
+  stats.warmup_orders =
+      std::min(options.warmup_rows.value_or(reader.header().warmup_rows), stats.total_orders);
+}
 
-  std::size_t warmup_limit = std::min(warmup_rows, total_rows);
-  std::size_t bench_limit = total_rows - warmup_limit;
+template <typename Source>
+BenchStats bench_source(Source &reader, const BenchOptions &options) {
+  BenchStats stats{};
+  init_stats(stats, reader, options);
 
-  MatchingEngine engine;
-  std::vector<double> latencies;
-  double worst_latency_us = 0.0;
+  MatchingEngine engine(AllocationRules{options.allocation, {}});
+  LatencyHistogram latencies;
+  const TscClock &clock = TscClock::instance();
+  stats.timer = clock.describe();
+  PhaseCounters perf(options.perf_counters, stats);
+  SpikeDumper spikes(options.spike_dump_prefix,
+                     options.spike_dump_ns != 0 ? options.spike_dump_ns : UINT64_MAX);
 
-  std::size_t warmup_ct = 0;
-  std::string warmup_line;
-  while (warmup_ct < warmup_limit && std::getline(file, warmup_line)) {
-    Order order;
-    if (!parse_order_line(warmup_line, order)) {
-      std::cout << "Failed to parse line: " << warmup_line << std::endl;
-      break;
-    }
-    engine.insert(order);
-    ++warmup_ct;
-  }
+  std::unique_ptr<Journal> journal;
+  std::uint64_t journaled = 0;
 
-  std::size_t bench_ct = 0;
-  std::string line;
   auto bench_start = std::chrono::steady_clock::now();
-  while (bench_ct < bench_limit && std::getline(file, line)) {
-    Order order;
-    if (!parse_order_line(line, order)) {
-      std::cout << "Failed to parse line: " << line << std::endl;
-      break;
-    }
-    auto start = std::chrono::steady_clock::now();
-    engine.submit(order);
-    auto finish = std::chrono::steady_clock::now();
-    double latency_us =
-        std::chrono::duration<double, std::micro>(finish - start).count();
-    latencies.push_back(latency_us);
-    worst_latency_us = std::max(worst_latency_us, latency_us);
-    ++bench_ct;
-  }
+  bool bench_started = false;
+  replay_dataset(
+      reader, stats.warmup_orders,
+      [&](std::span<const Order> batch) {
+        perf.resume();
+        auto load_start = std::chrono::steady_clock::now();
+        engine.bulk_insert(batch, options.load_threads);
+        stats.warmup_time_us += std::chrono::duration<double, std::micro>(
+                                    std::chrono::steady_clock::now() - load_start)
+                                    .count();
+        perf.pause();
+      },
+      [&](std::span<const Order> batch) {
+        if (!bench_started) {
+          if (!options.journal_path.empty()) {
+            std::remove(options.journal_path.c_str());
+            journal = std::make_unique<Journal>(options.journal_path, engine.sequence());
+            if (!journal->ok()) {
+              std::cout << "Journal disabled: " << journal->error() << std::endl;
+              journal.reset();
+            }
+          }
+          perf.end_warmup();
+          bench_start = std::chrono::steady_clock::now();
+          bench_started = true;
+        }
+        perf.resume();
+        for (const Order &order : batch) {
+          std::uint64_t start = clock.start();
+          if (journal) {
+            journaled = journal->append(order);
+          }
+          engine.submit(order);
+          std::uint64_t ns = clock.to_ns(clock.stop() - start);
+          latencies.record(ns);
+          spikes.check(ns);
+        }
+        perf.pause();
+      });
   auto bench_finish = std::chrono::steady_clock::now();
   stats.total_time_us =
       std::chrono::duration<double, std::micro>(bench_finish - bench_start)
           .count();
+  perf.finish();
+  if (journal) {
+    journal->wait_durable(journaled);
+    stats.journal_syncs = journal->syncs();
+  }
 
-  if (!latencies.empty()) {
-    stats.num_orders = latencies.size();
-    stats.mean_latency =
-        std::accumulate(latencies.begin(), latencies.end(), 0.0) /
-        static_cast<double>(latencies.size());
+  fill_latency_stats(latencies, stats);
+  return stats;
+}
 
-    std::vector<double> temp = latencies;
-    auto idx50 = temp.begin() + static_cast<std::size_t>(0.50 * temp.size());
-    std::nth_element(temp.begin(), idx50, temp.end());
-    stats.p50_latency = *idx50;
+// Counts trades so submit_batch() has somewhere to deliver them.
+class CountingTradeSink : public TradeSink {
+public:
+  void on_trades(const Order &, std::span<const Trade> trades) override {
+    trades_ += trades.size();
+  }
+  std::size_t trades() const { return trades_; }
 
-    temp = latencies;
-    auto idx95 = temp.begin() + static_cast<std::size_t>(0.95 * temp.size());
-    std::nth_element(temp.begin(), idx95, temp.end());
-    stats.p95_latency = *idx95;
+private:
+  std::size_t trades_ = 0;
+};
 
-    temp = latencies;
-    auto idx99 = temp.begin() + static_cast<std::size_t>(0.99 * temp.size());
-    std::nth_element(temp.begin(), idx99, temp.end());
-    stats.p99_latency = *idx99;
-    stats.worst_latency_us = worst_latency_us;
+template <typename Source>
+BenchStats batch_bench_source(Source &reader, const BenchOptions &options) {
+  BenchStats stats{};
+  init_stats(stats, reader, options);
+  stats.num_orders = stats.total_orders - stats.warmup_orders;
+  PhaseCounters perf(options.perf_counters, stats);
+
+  MatchingEngine engine(AllocationRules{options.allocation, {}});
+  std::vector<Order> measured;
+  replay_dataset(
+      reader, stats.warmup_orders,
+      [&](std::span<const Order> batch) {
+        perf.resume();
+        auto load_start = std::chrono::steady_clock::now();
+        engine.bulk_insert(batch, options.load_threads);
+        stats.warmup_time_us += std::chrono::duration<double, std::micro>(
+                                    std::chrono::steady_clock::now() - load_start)
+                                    .count();
+        perf.pause();
+      },
+      [&](std::span<const Order> batch) {
+        if (options.batch_mode == BatchMode::SubmitBatch) {
+          measured.insert(measured.end(), batch.begin(), batch.end());
+          return;
+        }
+        for (const Order &order : batch) {
+          engine.add(order);
+        }
+      });
+
+  CountingTradeSink sink;
+  perf.end_warmup();
+  perf.resume();
+  auto start = std::chrono::steady_clock::now();
+  switch (options.batch_mode) {
+  case BatchMode::Run:
+    engine.run();
+    break;
+  case BatchMode::Grouped:
+    engine.run_grouped();
+    break;
+  case BatchMode::SubmitBatch:
+    engine.submit_batch(measured, sink);
+    break;
   }
-
+  auto finish = std::chrono::steady_clock::now();
+  perf.pause();
+  perf.finish();
+  stats.total_time_us = std::chrono::duration<double, std::micro>(finish - start).count();
+  stats.timer = "steady_clock";
   return stats;
 }
 
-double run_engine_bench(const std::string &filename) {
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    std::cout << "Failed to open file: " << filename << std::endl;
-    return 0.0;
+} // namespace
+
+void fill_latency_stats(const LatencyHistogram &latencies, BenchStats &stats) {
+  auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1e3; };
+  stats.num_orders = latencies.count();
+  stats.mean_latency = latencies.mean() / 1e3;
+  stats.p50_latency = us(latencies.percentile(50.0));
+  stats.p95_latency = us(latencies.percentile(95.0));
+  stats.p99_latency = us(latencies.percentile(99.0));
+  stats.p999_latency = us(latencies.percentile(99.9));
+  stats.p9999_latency = us(latencies.percentile(99.99));
+  stats.p99999_latency = us(latencies.percentile(99.999));
+  stats.worst_latency_us = us(latencies.max());
+}
+
+BenchStats run_bench(const std::string &filename, const BenchOptions &options) {
+  DatasetReader reader(filename);
+  if (!reader.is_open()) {
+    std::cout << "Failed to open dataset: " << filename << std::endl;
+    return BenchStats{};
   }
+  return bench_source(reader, options);
+}
 
-  std::string header_line;
-  if (!std::getline(file, header_line)) {
-    std::cout << "Error: missing header line" << std::endl;
-    return 0.0;
+BenchStats run_bench(const GeneratorConfig &config, const BenchOptions &options) {
+  OrderGenerator generator(config);
+  return bench_source(generator, options);
+}
+
+BenchStats run_batch_bench(const std::string &filename, const BenchOptions &options) {
+  DatasetReader reader(filename);
+  if (!reader.is_open()) {
+    std::cout << "Failed to open dataset: " << filename << std::endl;
+    return BenchStats{};
   }
+  return batch_bench_source(reader, options);
+}
 
-  std::size_t total_rows = 0;
-  std::size_t warmup_rows = 0;
-  std::string_view header_sv(header_line);
-  auto comma = header_sv.find(',');
-  std::from_chars(header_sv.data(), header_sv.data() + comma, total_rows);
-  std::from_chars(header_sv.data() + comma + 1,
-                  header_sv.data() + header_sv.size(), warmup_rows);
+BenchStats run_batch_bench(const GeneratorConfig &config, const BenchOptions &options) {
+  OrderGenerator generator(config);
+  return batch_bench_source(generator, options);
+}
 
-  std::size_t warmup_limit = std::min(warmup_rows, total_rows);
-  std::size_t bench_limit = total_rows - warmup_limit;
+double run_engine_bench(const std::string &filename) {
+  return run_batch_bench(filename).total_time_us;
+}
 
-  MatchingEngine engine;
+double run_engine_bench(const GeneratorConfig &config) {
+  return run_batch_bench(config).total_time_us;
+}
 
-  std::size_t warmup_ct = 0;
-  std::string warmup_line;
-  while (warmup_ct < warmup_limit && std::getline(file, warmup_line)) {
-    Order order;
-    if (!parse_order_line(warmup_line, order)) {
-      std::cout << "Failed to parse line: " << warmup_line << std::endl;
+BenchEnvironment bench_environment() {
+  BenchEnvironment env;
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("model name", 0) == 0) {
+      auto colon = line.find(':');
+      if (colon != std::string::npos) {
+        env.cpu_model = line.substr(line.find_first_not_of(" \t", colon + 1));
+      }
       break;
     }
-    engine.insert(order);
-    ++warmup_ct;
   }
+  if (env.cpu_model.empty()) {
+    env.cpu_model = "unknown";
+  }
+#if defined(__clang__)
+  env.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+  env.compiler = "gcc " __VERSION__;
+#else
+  env.compiler = "unknown";
+#endif
+  env.compile_flags = FLASHMATCH_COMPILE_FLAGS;
+  env.git_revision = FLASHMATCH_GIT_REVISION;
+
+  char host[256] = {};
+  if (gethostname(host, sizeof(host) - 1) == 0) {
+    env.host = host;
+  }
+  utsname uts{};
+  if (uname(&uts) == 0) {
+    env.kernel = std::string(uts.sysname) + " " + uts.release;
+  }
+  return env;
+}
 
-  std::size_t bench_ct = 0;
-  std::string line;
-  while (bench_ct < bench_limit && std::getline(file, line)) {
-    Order order;
-    if (!parse_order_line(line, order)) {
-      std::cout << "Failed to parse line: " << line << std::endl;
-      break;
-    }
-    engine.add(order);
-    ++bench_ct;
+bool pin_thread_to_cpu(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+ParseStats run_parse_bench(const std::string &filename) {
+  ParseStats stats{};
+  MappedFile file(filename);
+  if (!file.is_open()) {
+    std::cout << "Failed to open file: " << filename << std::endl;
+    return stats;
+  }
+
+  // Skip the "total,warmup" header; only order rows are timed.
+  std::string_view data = file.view();
+  auto header_end = data.find('\n');
+  if (header_end == std::string_view::npos) {
+    std::cout << "Error: missing header line" << std::endl;
+    return stats;
   }
+  data.remove_prefix(header_end + 1);
+  stats.bytes = data.size();
 
+  Order order;
+  std::size_t baseline_rows = 0;
+  std::uint64_t baseline_sum = 0;
   auto start = std::chrono::steady_clock::now();
-  engine.run();
+  std::string_view rest = data;
+  while (!rest.empty()) {
+    auto eol = rest.find('\n');
+    std::string_view line = rest.substr(0, eol);
+    rest = (eol == std::string_view::npos) ? std::string_view{} : rest.substr(eol + 1);
+    if (line.empty()) {
+      continue;
+    }
+    if (!parse_order_line_baseline(line, order)) {
+      break;
+    }
+    baseline_sum += order_checksum(order);
+    ++baseline_rows;
+  }
   auto finish = std::chrono::steady_clock::now();
-  return std::chrono::duration<double, std::micro>(finish - start).count();
+  stats.baseline_time_us = std::chrono::duration<double, std::micro>(finish - start).count();
+
+  std::size_t simd_rows = 0;
+  std::uint64_t simd_sum = 0;
+  start = std::chrono::steady_clock::now();
+  CsvOrderScanner scanner(data.data(), data.data() + data.size());
+  while (scanner.next(order)) {
+    simd_sum += order_checksum(order);
+    ++simd_rows;
+  }
+  finish = std::chrono::steady_clock::now();
+  stats.simd_time_us = std::chrono::duration<double, std::micro>(finish - start).count();
+
+  if (scanner.failed()) {
+    std::cout << "Failed to parse line: " << scanner.last_line() << std::endl;
+  }
+  stats.rows = simd_rows;
+  stats.results_match = !scanner.failed() && simd_rows == baseline_rows && simd_sum == baseline_sum;
+  return stats;
+}
+
+void output_parse_stats(const ParseStats &stats) {
+  auto gb_per_s = [&](double time_us) {
+    return time_us > 0.0 ? static_cast<double>(stats.bytes) / (time_us * 1e3) : 0.0;
+  };
+  auto mrows_per_s = [&](double time_us) {
+    return time_us > 0.0 ? static_cast<double>(stats.rows) / time_us : 0.0;
+  };
+  std::cout << "=== Flashmatch Parse Benchmark ===\n";
+  std::cout << "Bytes parsed:          " << stats.bytes << "\n";
+  std::cout << "Rows parsed:           " << stats.rows << "\n";
+  std::cout << "Kernel:                " << csv_kernel_name() << "\n";
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Baseline parser:       " << gb_per_s(stats.baseline_time_us) << " GB/s, "
+            << mrows_per_s(stats.baseline_time_us) << " M rows/s" << std::endl;
+  std::cout << "SIMD parser:           " << gb_per_s(stats.simd_time_us) << " GB/s, "
+            << mrows_per_s(stats.simd_time_us) << " M rows/s" << std::endl;
+  std::cout << "Results match:         " << (stats.results_match ? "yes" : "no") << std::endl;
+}
+
+void output_perf_counts(const BenchStats &stats) {
+  if (!stats.perf_note.empty()) {
+    std::cout << "Perf counters:         " << stats.perf_note << std::endl;
+  }
+  if (!stats.warmup_counters.any() && !stats.bench_counters.any()) {
+    return;
+  }
+  auto per_order = [](const PerfCounts &counts, PerfEvent event, std::size_t orders) {
+    return orders == 0 ? 0.0
+                       : static_cast<double>(counts[event]) / static_cast<double>(orders);
+  };
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Per order:            " << std::setw(12) << "warmup" << std::setw(14) << "measured"
+            << std::endl;
+  for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+    auto event = static_cast<PerfEvent>(i);
+    if (!stats.bench_counters.has(event) && !stats.warmup_counters.has(event)) {
+      continue;
+    }
+    std::string name = std::string("  ") + perf_event_name(event);
+    name.resize(22, ' ');
+    std::cout << name << std::setw(12) << per_order(stats.warmup_counters, event, stats.warmup_orders)
+              << std::setw(14) << per_order(stats.bench_counters, event, stats.num_orders)
+              << std::endl;
+  }
+  if (stats.bench_counters.has(PerfEvent::Cycles) &&
+      stats.bench_counters.has(PerfEvent::Instructions) &&
+      stats.bench_counters[PerfEvent::Cycles] > 0) {
+    std::cout << "  IPC                 " << std::setw(12) << "" << std::setw(14)
+              << static_cast<double>(stats.bench_counters[PerfEvent::Instructions]) /
+                     static_cast<double>(stats.bench_counters[PerfEvent::Cycles])
+              << std::endl;
+  }
 }
 
 void output_stats(const BenchStats &stats) {
@@ -199,19 +506,43 @@ void output_stats(const BenchStats &stats) {
   std::cout << "Warmup orders:         " << stats.warmup_orders << "\n";
   std::cout << "Orders processed:      " << stats.num_orders << "\n";
   std::cout << std::fixed << std::setprecision(1);
-  std::cout << "Mean latency:          " << stats.mean_latency
-            << " micro-seconds" << std::endl;
-  std::cout << "Median latency:        " << stats.p50_latency
-            << " micro-seconds" << std::endl;
-  std::cout << "95th percentile:       " << stats.p95_latency
-            << " micro-seconds" << std::endl;
-  std::cout << "99th percentile:       " << stats.p99_latency
-            << " micro-seconds" << std::endl;
-  std::cout << "Worst-case latency:    " << stats.worst_latency_us
+  // Batch runs time run() as a whole and carry no per-order latencies.
+  if (stats.worst_latency_us > 0.0) {
+    std::cout << "Mean latency:          " << stats.mean_latency
+              << " micro-seconds" << std::endl;
+    std::cout << "Median latency:        " << stats.p50_latency
+              << " micro-seconds" << std::endl;
+    std::cout << "95th percentile:       " << stats.p95_latency
+              << " micro-seconds" << std::endl;
+    std::cout << "99th percentile:       " << stats.p99_latency
+              << " micro-seconds" << std::endl;
+    std::cout << "99.9th percentile:     " << stats.p999_latency
+              << " micro-seconds" << std::endl;
+    std::cout << "99.99th percentile:    " << stats.p9999_latency
+              << " micro-seconds" << std::endl;
+    std::cout << "99.999th percentile:   " << stats.p99999_latency
+              << " micro-seconds" << std::endl;
+    std::cout << "Worst-case latency:    " << stats.worst_latency_us
+              << " micro-seconds" << std::endl;
+  }
+  std::cout << "Warmup load time:      " << stats.warmup_time_us
             << " micro-seconds" << std::endl;
   std::cout << "Total loop time:       " << stats.total_time_us
             << " micro-seconds" << std::endl;
-  std::cout << "Compiler flags:        -O3 -march=native" << std::endl;
+  if (stats.total_time_us > 0.0) {
+    std::cout << "Throughput:            "
+              << static_cast<double>(stats.num_orders) / stats.total_time_us
+              << " M orders/s" << std::endl;
+  }
+  std::cout << "Timer:                 " << stats.timer << std::endl;
+  if (stats.journal_syncs > 0) {
+    std::cout << "Journal group commits: " << stats.journal_syncs << std::endl;
+  }
+  output_perf_counts(stats);
+  const BenchEnvironment env = bench_environment();
+  std::cout << "CPU:                   " << env.cpu_model << std::endl;
+  std::cout << "Compiler:              " << env.compiler << std::endl;
+  std::cout << "Compiler flags:        " << env.compile_flags << std::endl;
 }
 
 } // namespace fm
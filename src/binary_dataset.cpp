@@ -0,0 +1,184 @@
+#include "flashmatch/binary_dataset.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <unordered_set>
+#include <utility>
+
+#include "flashmatch/dataset_reader.hpp"
+#include "flashmatch/symbol_map.hpp"
+
+namespace fm {
+
+namespace {
+
+constexpr std::size_t kWriteBatch = 1 << 16;
+
+std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+
+} // namespace
+
+bool is_binary_dataset(std::string_view data) {
+  return data.size() >= sizeof(kBinaryDatasetMagic) &&
+         std::memcmp(data.data(), kBinaryDatasetMagic, sizeof(kBinaryDatasetMagic)) == 0;
+}
+
+bool BinaryDatasetView::open(std::string_view data) {
+  if (!is_binary_dataset(data) || data.size() < sizeof(BinaryDatasetHeader)) {
+    return false;
+  }
+  std::memcpy(&header_, data.data(), sizeof(header_));
+  if (header_.version != kBinaryDatasetVersion) {
+    return false;
+  }
+  const std::size_t table_begin = sizeof(BinaryDatasetHeader);
+  if (header_.symbol_table_bytes > data.size() - table_begin) {
+    return false;
+  }
+  const std::size_t records_begin = table_begin + header_.symbol_table_bytes;
+  if (header_.record_count > (data.size() - records_begin) / sizeof(PackedOrder)) {
+    return false;
+  }
+
+  symbols_.clear();
+  symbols_.reserve(header_.symbol_count);
+  symbol_hashes_.clear();
+  std::string_view table = data.substr(table_begin, header_.symbol_table_bytes);
+  for (std::uint32_t i = 0; i < header_.symbol_count; ++i) {
+    std::uint16_t length = 0;
+    if (table.size() < sizeof(length)) {
+      return false;
+    }
+    std::memcpy(&length, table.data(), sizeof(length));
+    table.remove_prefix(sizeof(length));
+    if (table.size() < length) {
+      return false;
+    }
+    symbols_.emplace_back(table.substr(0, length));
+    symbol_hashes_.push_back(symbol_hash(symbols_.back()));
+    table.remove_prefix(length);
+  }
+
+  records_ = std::span<const PackedOrder>(
+      reinterpret_cast<const PackedOrder *>(data.data() + records_begin), header_.record_count);
+  return true;
+}
+
+bool BinaryDatasetView::unpack(const PackedOrder &record, Order &out) const {
+  if (record.symbol >= symbols_.size()) {
+    return false;
+  }
+  out.id = record.id;
+  out.symbol.assign(symbols_[record.symbol]);
+  out.symbol_hash = symbol_hashes_[record.symbol];
+  out.side = static_cast<Side>(record.side);
+  out.price = record.price;
+  out.quantity = record.quantity;
+  out.type = static_cast<OrderType>(record.type);
+  return true;
+}
+
+BinaryDatasetWriter::BinaryDatasetWriter(const std::string &path,
+                                         const DatasetHeader &header,
+                                         std::vector<std::string> symbols)
+    : out_(path, std::ios::binary | std::ios::trunc) {
+  std::memcpy(header_.magic, kBinaryDatasetMagic, sizeof(kBinaryDatasetMagic));
+  header_.version = kBinaryDatasetVersion;
+  header_.symbol_count = static_cast<std::uint32_t>(symbols.size());
+  header_.total_rows = header.total_rows;
+  header_.warmup_rows = header.warmup_rows;
+
+  std::string table;
+  for (std::uint32_t i = 0; i < symbols.size(); ++i) {
+    auto length = static_cast<std::uint16_t>(symbols[i].size());
+    table.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    table.append(symbols[i], 0, length);
+    index_.emplace(std::move(symbols[i]), i);
+  }
+  table.resize(padded(table.size()), '\0');
+  header_.symbol_table_bytes = table.size();
+
+  out_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+  out_.write(table.data(), static_cast<std::streamsize>(table.size()));
+  buffer_.reserve(kWriteBatch);
+}
+
+bool BinaryDatasetWriter::append(const Order &order) {
+  auto it = index_.find(order.symbol);
+  if (it == index_.end()) {
+    return false;
+  }
+  buffer_.push_back(PackedOrder{order.id,
+                                order.price,
+                                order.quantity,
+                                it->second,
+                                static_cast<std::uint8_t>(order.side),
+                                static_cast<std::uint8_t>(order.type),
+                                0});
+  if (buffer_.size() == kWriteBatch) {
+    return flush();
+  }
+  return true;
+}
+
+bool BinaryDatasetWriter::flush() {
+  out_.write(reinterpret_cast<const char *>(buffer_.data()),
+             static_cast<std::streamsize>(buffer_.size() * sizeof(PackedOrder)));
+  header_.record_count += buffer_.size();
+  buffer_.clear();
+  return out_.good();
+}
+
+bool BinaryDatasetWriter::finish() {
+  if (!flush()) {
+    return false;
+  }
+  out_.seekp(0);
+  out_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+  out_.close();
+  return !out_.fail();
+}
+
+bool convert_csv_to_binary(const std::string &csv_path,
+                           const std::string &bin_path,
+                           std::size_t threads) {
+  DatasetReader reader(csv_path, threads);
+  if (!reader.is_open()) {
+    std::cout << "Failed to open dataset: " << csv_path << std::endl;
+    return false;
+  }
+
+  std::vector<std::string> symbols;
+  std::unordered_set<std::string> seen;
+  bool ok = reader.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      if (seen.insert(order.symbol).second) {
+        symbols.push_back(order.symbol);
+      }
+    }
+    return true;
+  });
+  if (!ok) {
+    std::cout << "Failed to parse line: " << reader.error_line() << std::endl;
+    return false;
+  }
+
+  BinaryDatasetWriter writer(bin_path, reader.header(), std::move(symbols));
+  if (!writer.is_open()) {
+    std::cout << "Failed to open output: " << bin_path << std::endl;
+    return false;
+  }
+  bool written = true;
+  ok = reader.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      if (!writer.append(order)) {
+        written = false;
+        return false;
+      }
+    }
+    return true;
+  });
+  return ok && written && writer.finish();
+}
+
+} // namespace fm
@@ -0,0 +1,33 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "flashmatch/binary_dataset.hpp"
+#include "flashmatch/dataset_reader.hpp"
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    std::cout << "Usage: " << argv[0] << " <input.csv> <output.bin>" << std::endl;
+    return 1;
+  }
+  const std::string input = argv[1];
+  const std::string output = argv[2];
+
+  auto start = std::chrono::steady_clock::now();
+  if (!fm::convert_csv_to_binary(input, output)) {
+    std::cout << "Conversion failed" << std::endl;
+    return 1;
+  }
+  auto finish = std::chrono::steady_clock::now();
+
+  fm::DatasetReader reader(output);
+  if (!reader.is_open()) {
+    std::cout << "Written file is not a valid dataset: " << output << std::endl;
+    return 1;
+  }
+  std::cout << "Total orders:          " << reader.header().total_rows << "\n";
+  std::cout << "Warmup orders:         " << reader.header().warmup_rows << "\n";
+  std::cout << "Conversion time:       "
+            << std::chrono::duration<double>(finish - start).count() << " seconds" << std::endl;
+  return 0;
+}
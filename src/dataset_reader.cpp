@@ -0,0 +1,269 @@
+#include "flashmatch/dataset_reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "flashmatch/gzip_dataset.hpp"
+#include "flashmatch/high_perf_csv_parser.hpp"
+#include "flashmatch/jsonl_order_parser.hpp"
+
+namespace fm {
+
+namespace {
+
+// One in-flight chunk. Its Order array is reused for every chunk that maps to
+// the slot, so symbol strings keep their capacity between chunks.
+struct ChunkSlot {
+  std::vector<Order> orders;
+  std::size_t count = 0;
+  std::size_t chunk = 0;
+  bool ready = false;
+  bool failed = false;
+  std::string error_line;
+};
+
+std::vector<std::string_view> split_chunks(std::string_view body, std::size_t chunk_bytes) {
+  std::vector<std::string_view> chunks;
+  while (!body.empty()) {
+    std::size_t cut = body.size();
+    if (chunk_bytes < body.size()) {
+      auto eol = body.find('\n', chunk_bytes);
+      cut = (eol == std::string_view::npos) ? body.size() : eol + 1;
+    }
+    chunks.push_back(body.substr(0, cut));
+    body.remove_prefix(cut);
+  }
+  return chunks;
+}
+
+void parse_chunk(std::string_view chunk, RowFormat format, ChunkSlot &slot) {
+  slot.failed = !parse_rows(chunk, format, slot.orders, slot.count, slot.error_line);
+}
+
+template <typename Scanner>
+bool scan_rows(Scanner &scanner, std::vector<Order> &orders, std::size_t &count) {
+  count = 0;
+  while (true) {
+    if (count == orders.size()) {
+      orders.emplace_back();
+    }
+    if (!scanner.next(orders[count])) {
+      return !scanner.failed();
+    }
+    ++count;
+  }
+}
+
+} // namespace
+
+RowFormat detect_row_format(std::string_view body) {
+  auto first = body.find_first_not_of(" \t\r\n");
+  return (first != std::string_view::npos && body[first] == '{') ? RowFormat::JsonLines
+                                                                  : RowFormat::Csv;
+}
+
+bool parse_rows(std::string_view text,
+                RowFormat format,
+                std::vector<Order> &orders,
+                std::size_t &count,
+                std::string &error_line) {
+  const char *begin = text.data();
+  const char *end = begin + text.size();
+  if (format == RowFormat::JsonLines) {
+    JsonOrderScanner scanner(begin, end);
+    if (!scan_rows(scanner, orders, count)) {
+      error_line = std::string(scanner.last_line());
+      return false;
+    }
+    return true;
+  }
+  CsvOrderScanner scanner(begin, end);
+  if (!scan_rows(scanner, orders, count)) {
+    error_line = std::string(scanner.last_line());
+    return false;
+  }
+  return true;
+}
+
+bool parse_dataset_header(std::string_view line, DatasetHeader &out) {
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  auto comma = line.find(',');
+  if (comma == std::string_view::npos) {
+    return false;
+  }
+  const char *last = line.data() + line.size();
+  auto total = std::from_chars(line.data(), line.data() + comma, out.total_rows);
+  auto warmup = std::from_chars(line.data() + comma + 1, last, out.warmup_rows);
+  return total.ec == std::errc() && warmup.ec == std::errc() && warmup.ptr == last;
+}
+
+DatasetReader::DatasetReader(const std::string &path,
+                             std::size_t threads,
+                             std::size_t chunk_bytes)
+    : file_(path),
+      threads_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      chunk_bytes_(std::max<std::size_t>(chunk_bytes, 1)) {
+  if (!file_.is_open()) {
+    return;
+  }
+  std::string_view data = file_.view();
+  if (is_binary_dataset(data)) {
+    if (!binary_.open(data)) {
+      return;
+    }
+    header_.total_rows = binary_.header().total_rows;
+    header_.warmup_rows = binary_.header().warmup_rows;
+    is_binary_ = true;
+    open_ = true;
+    return;
+  }
+  if (is_gzip_dataset(data)) {
+    if (!GzipOrderStream(data).read_header(header_)) {
+      return;
+    }
+    is_gzip_ = true;
+    open_ = true;
+    return;
+  }
+  auto eol = data.find('\n');
+  std::string_view header_line = data.substr(0, eol);
+  if (!parse_dataset_header(header_line, header_)) {
+    return;
+  }
+  body_ = (eol == std::string_view::npos) ? std::string_view{} : data.substr(eol + 1);
+  format_ = detect_row_format(body_);
+  open_ = true;
+}
+
+bool DatasetReader::for_each_batch(const OrderBatchSink &sink) {
+  error_line_.clear();
+  if (!open_) {
+    return false;
+  }
+  if (is_gzip_) {
+    return GzipOrderStream(file_.view()).for_each_batch(sink, error_line_);
+  }
+  return is_binary_ ? read_binary(sink) : parse_chunks(sink);
+}
+
+bool DatasetReader::read_binary(const OrderBatchSink &sink) {
+  constexpr std::size_t kBatch = 1 << 16;
+  auto records = binary_.records();
+  std::vector<Order> batch(std::min(kBatch, records.size()));
+  for (std::size_t offset = 0; offset < records.size(); offset += kBatch) {
+    std::size_t count = std::min(kBatch, records.size() - offset);
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!binary_.unpack(records[offset + i], batch[i])) {
+        error_line_ = "record " + std::to_string(offset + i) + ": symbol index out of range";
+        return false;
+      }
+    }
+    if (!sink(std::span<const Order>(batch.data(), count))) {
+      return true;
+    }
+  }
+  return true;
+}
+
+bool DatasetReader::parse_chunks(const OrderBatchSink &sink) {
+  const auto chunks = split_chunks(body_, chunk_bytes_);
+  const std::size_t workers = std::min(threads_, chunks.size());
+
+  if (workers <= 1) {
+    ChunkSlot slot;
+    for (auto chunk : chunks) {
+      parse_chunk(chunk, format_, slot);
+      if (slot.count > 0 && !sink(std::span<const Order>(slot.orders.data(), slot.count))) {
+        return true;
+      }
+      if (slot.failed) {
+        error_line_ = slot.error_line;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Workers claim chunks in order and may run at most `window` chunks ahead
+  // of the consumer, which bounds memory to window chunk arrays.
+  const std::size_t window = workers * 2;
+  std::vector<ChunkSlot> slots(window);
+  std::mutex mutex;
+  std::condition_variable slot_ready;
+  std::condition_variable slot_free;
+  std::atomic<std::size_t> next_chunk{0};
+  std::size_t consumed = 0;
+  bool stop = false;
+
+  auto worker = [&] {
+    while (true) {
+      std::size_t i = next_chunk.fetch_add(1, std::memory_order_relaxed);
+      if (i >= chunks.size()) {
+        return;
+      }
+      ChunkSlot &slot = slots[i % window];
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        slot_free.wait(lock, [&] { return stop || i < consumed + window; });
+        if (stop) {
+          return;
+        }
+      }
+      parse_chunk(chunks[i], format_, slot);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        slot.chunk = i;
+        slot.ready = true;
+      }
+      slot_ready.notify_all();
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers);
+  for (std::size_t t = 0; t < workers; ++t) {
+    pool.emplace_back(worker);
+  }
+
+  bool ok = true;
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    ChunkSlot &slot = slots[i % window];
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      slot_ready.wait(lock, [&] { return slot.ready && slot.chunk == i; });
+    }
+    bool keep_going =
+        slot.count == 0 || sink(std::span<const Order>(slot.orders.data(), slot.count));
+    if (keep_going && slot.failed) {
+      error_line_ = slot.error_line;
+      ok = false;
+      keep_going = false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      slot.ready = false;
+      ++consumed;
+      stop = !keep_going;
+    }
+    slot_free.notify_all();
+    if (!keep_going) {
+      break;
+    }
+  }
+
+  for (auto &t : pool) {
+    t.join();
+  }
+  return ok;
+}
+
+} // namespace fm
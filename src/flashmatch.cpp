@@ -1,5 +1,115 @@
 #include "flashmatch/flashmatch.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "flashmatch/matching_engine.hpp"
+#include "flashmatch/recovery.hpp"
+
+namespace {
+
+struct RecoverOptions {
+  // A snapshot file, or a directory whose latest *.snap is used.
+  std::string snapshot;
+  std::string journal;
+  std::size_t load_threads = 0;
+  // Where to write a snapshot of the recovered engine, if anywhere.
+  std::string save_snapshot;
+};
+
+void print_usage(const char *argv0) {
+  std::cout << "Usage: " << argv0 << " [--recover [options]]\n"
+            << "  --recover           Rebuild the books from a snapshot and the journal\n"
+            << "                      tail written after it, then report how long it took\n"
+            << "  --snapshot PATH     Snapshot file, or a directory to take the latest\n"
+            << "                      *.snap from\n"
+            << "  --journal PATH      Journal to replay after the snapshot\n"
+            << "  --load-threads N    Threads restoring snapshot books (default 0 = one\n"
+            << "                      per CPU)\n"
+            << "  --save-snapshot P   Snapshot the recovered engine to P\n";
+}
+
+bool parse_recover_options(int argc, char *argv[], RecoverOptions &options) {
+  for (int i = 2; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    const char *value = i + 1 < argc ? argv[++i] : nullptr;
+    if (value == nullptr) {
+      std::cout << "Expected a value after " << arg << std::endl;
+      return false;
+    }
+    if (arg == "--snapshot") {
+      options.snapshot = value;
+    } else if (arg == "--journal") {
+      options.journal = value;
+    } else if (arg == "--save-snapshot") {
+      options.save_snapshot = value;
+    } else if (arg == "--load-threads") {
+      char *end = nullptr;
+      options.load_threads = std::strtoull(value, &end, 10);
+      if (end == value || *end != '\0') {
+        std::cout << "Expected a number after " << arg << std::endl;
+        return false;
+      }
+    } else {
+      std::cout << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options.snapshot.empty() && options.journal.empty()) {
+    std::cout << "--recover needs --snapshot, --journal or both" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int run_recovery(RecoverOptions options) {
+  if (!options.snapshot.empty() && std::filesystem::is_directory(options.snapshot)) {
+    std::string latest = fm::latest_snapshot(options.snapshot);
+    if (latest.empty()) {
+      std::cout << "No snapshot in " << options.snapshot << std::endl;
+      return 1;
+    }
+    options.snapshot = latest;
+  }
+
+  fm::MatchingEngine engine;
+  fm::RecoveryStats stats;
+  if (!fm::recover(engine, options.snapshot, options.journal, stats, options.load_threads)) {
+    std::cout << "Recovery failed" << std::endl;
+    return 1;
+  }
+  const double total_us = stats.snapshot_time_us + stats.replay_time_us;
+  std::cout << "=== Flashmatch Recovery ===\n" << std::fixed << std::setprecision(1);
+  if (!options.snapshot.empty()) {
+    std::cout << "Snapshot:              " << options.snapshot << "\n";
+  }
+  std::cout << "Snapshot sequence:     " << stats.snapshot_sequence << "\n"
+            << "Snapshot load time:    " << stats.snapshot_time_us << " micro-seconds\n"
+            << "Records skipped:       " << stats.skipped << "\n"
+            << "Orders replayed:       " << stats.replayed << "\n"
+            << "Trades replayed:       " << stats.trades << "\n"
+            << "Replay time:           " << stats.replay_time_us << " micro-seconds\n";
+  if (stats.replay_time_us > 0.0) {
+    std::cout << "Replay throughput:     "
+              << static_cast<double>(stats.replayed) / stats.replay_time_us << " M orders/s\n";
+  }
+  std::cout << "Recovery time:         " << total_us << " micro-seconds\n"
+            << "Recovered sequence:    " << engine.sequence() << "\n"
+            << "Books:                 " << engine.book_count() << std::endl;
+  if (stats.torn_tail) {
+    std::cout << "Ignored an unsynced tail at the end of the journal" << std::endl;
+  }
+  if (!options.save_snapshot.empty() && !engine.save_snapshot(options.save_snapshot)) {
+    return 1;
+  }
+  return 0;
+}
+
+} // namespace
 
 int run_flashmatch() {
   std::cout << "Flashmatch starting..." << std::endl;
@@ -7,7 +117,17 @@ int run_flashmatch() {
 }
 
 int flashmatch_main(int argc, char *argv[]) {
-  // (void)argc;
-  // (void)argv;
+  if (argc > 1 && std::string_view(argv[1]) == "--recover") {
+    RecoverOptions options;
+    if (!parse_recover_options(argc, argv, options)) {
+      print_usage(argv[0]);
+      return 1;
+    }
+    return run_recovery(std::move(options));
+  }
+  if (argc > 1) {
+    print_usage(argv[0]);
+    return 1;
+  }
   return run_flashmatch();
 }
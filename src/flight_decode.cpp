@@ -0,0 +1,103 @@
+// Prints a flight recorder dump, all threads merged in timestamp order.
+//
+//   flight_decode flashmatch_spike.0.fr --last 200
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flashmatch/flight_recorder.hpp"
+
+namespace {
+
+struct Row {
+  int thread_id;
+  const fm::FlightEvent *event;
+};
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::string path;
+  std::size_t last = 0;
+  int thread = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if ((arg == "--last" || arg == "--thread") && i + 1 < argc) {
+      if (arg == "--last") {
+        last = std::strtoull(argv[++i], nullptr, 10);
+      } else {
+        thread = std::atoi(argv[++i]);
+      }
+    } else if (!arg.starts_with("--") && path.empty()) {
+      path = arg;
+    } else {
+      path.clear();
+      break;
+    }
+  }
+  if (path.empty()) {
+    std::cout << "Usage: " << argv[0] << " <dump.fr> [--last N] [--thread TID]" << std::endl;
+    return 1;
+  }
+
+  fm::FlightDump dump;
+  if (!fm::read_flight_dump(path, dump)) {
+    return 1;
+  }
+  std::vector<Row> rows;
+  for (const auto &t : dump.threads) {
+    if (thread != 0 && t.thread_id != thread) {
+      continue;
+    }
+    for (const fm::FlightEvent &event : t.events) {
+      rows.push_back({t.thread_id, &event});
+    }
+  }
+  std::stable_sort(rows.begin(), rows.end(),
+                   [](const Row &a, const Row &b) { return a.event->tsc < b.event->tsc; });
+  if (last != 0 && rows.size() > last) {
+    rows.erase(rows.begin(), rows.end() - static_cast<std::ptrdiff_t>(last));
+  }
+  if (rows.empty()) {
+    std::cout << "No events" << std::endl;
+    return 0;
+  }
+
+  // Times are relative to the newest event, so the spike is at 0.
+  const std::uint64_t newest = rows.back().event->tsc;
+  std::cout << std::fixed;
+  for (const Row &row : rows) {
+    const fm::FlightEvent &e = *row.event;
+    double us = -static_cast<double>(newest - e.tsc) * dump.ns_per_tick / 1000.0;
+    std::string symbol(e.symbol, strnlen(e.symbol, sizeof(e.symbol)));
+    std::cout << std::setw(7) << row.thread_id << std::setprecision(3) << std::setw(12) << us
+              << " us  " << std::left << std::setw(8) << fm::flight_event_name(e.type)
+              << std::setw(10) << symbol << std::right << " order=" << e.order_id
+              << (e.side == static_cast<std::uint8_t>(Side::BUY) ? " BUY" : " SELL")
+              << (e.order_type == static_cast<std::uint8_t>(OrderType::IOC) ? " IOC" : "")
+              << std::setprecision(4) << " price=" << e.price;
+    switch (e.type) {
+    case fm::FlightEventType::Trade:
+      std::cout << " qty=" << e.quantity << " resting=" << e.other_id;
+      break;
+    case fm::FlightEventType::Matched:
+      std::cout << " filled=" << e.quantity << " trades=" << e.other_id;
+      break;
+    case fm::FlightEventType::OrderReceived:
+    case fm::FlightEventType::Rested:
+      std::cout << " qty=" << e.quantity;
+      break;
+    default:
+      break;
+    }
+    std::cout << "\n";
+  }
+  std::cout << std::flush;
+  return 0;
+}
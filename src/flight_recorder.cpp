@@ -0,0 +1,230 @@
+#include "flashmatch/flight_recorder.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+
+namespace fm {
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'M', 'F', 'L', 'I', 'G', 'H', 'T'};
+constexpr std::uint32_t kVersion = 1;
+
+struct DumpHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t rings;
+  double ns_per_tick;
+};
+
+struct RingHeader {
+  std::int32_t thread_id;
+  std::uint32_t reserved;
+  std::uint64_t events;
+};
+
+// Fixed table so a signal handler can walk it. Rings are never freed.
+std::array<std::atomic<FlightRing *>, FlightRecorder::kMaxRings> g_rings{};
+
+char g_signal_path[4096];
+
+bool write_all(int fd, const void *data, std::size_t size) {
+  const char *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t n = write(fd, bytes, size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    bytes += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+void on_signal(int) {
+  int saved = errno;
+  int fd = open(g_signal_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd >= 0) {
+    dump_flight_recorder(fd);
+    close(fd);
+  }
+  errno = saved;
+}
+
+} // namespace
+
+const char *flight_event_name(FlightEventType type) {
+  switch (type) {
+  case FlightEventType::OrderReceived:
+    return "RECV";
+  case FlightEventType::Matched:
+    return "MATCHED";
+  case FlightEventType::Rested:
+    return "RESTED";
+  case FlightEventType::Trade:
+    return "TRADE";
+  case FlightEventType::LevelCreated:
+    return "LEVEL+";
+  case FlightEventType::LevelErased:
+    return "LEVEL-";
+  }
+  return "UNKNOWN";
+}
+
+// Marks the calling thread's ring free on thread exit. Its events stay
+// dumpable until another thread claims it.
+struct RingReleaser {
+  FlightRing *ring = nullptr;
+  ~RingReleaser() {
+    if (ring != nullptr) {
+      FlightRecorder::local_ring_ = nullptr;
+      ring->in_use.store(false, std::memory_order_release);
+    }
+  }
+};
+
+FlightRing *FlightRecorder::attach_thread() {
+  FlightRing *ring = nullptr;
+  for (auto &slot : g_rings) {
+    FlightRing *existing = slot.load(std::memory_order_acquire);
+    if (existing == nullptr) {
+      auto fresh = std::make_unique<FlightRing>();
+      fresh->in_use.store(true, std::memory_order_relaxed);
+      if (slot.compare_exchange_strong(existing, fresh.get(), std::memory_order_acq_rel)) {
+        ring = fresh.release();
+        break;
+      }
+    }
+    bool idle = false;
+    if (existing->in_use.compare_exchange_strong(idle, true, std::memory_order_acq_rel)) {
+      existing->head.store(0, std::memory_order_release);
+      existing->stamp = 0;
+      ring = existing;
+      break;
+    }
+  }
+  if (ring == nullptr) {
+    return nullptr;
+  }
+  ring->thread_id = static_cast<int>(gettid());
+  thread_local RingReleaser releaser;
+  releaser.ring = ring;
+  local_ring_ = ring;
+  return ring;
+}
+
+bool dump_flight_recorder(int fd) {
+  std::array<FlightRing *, FlightRecorder::kMaxRings> rings{};
+  std::uint32_t count = 0;
+  for (auto &slot : g_rings) {
+    FlightRing *ring = slot.load(std::memory_order_acquire);
+    if (ring != nullptr && ring->head.load(std::memory_order_acquire) > 0) {
+      rings[count++] = ring;
+    }
+  }
+  DumpHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.rings = count;
+  header.ns_per_tick = count > 0 ? rings[0]->clock->ns_per_tick() : 1.0;
+  if (!write_all(fd, &header, sizeof(header))) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < count; ++i) {
+    const FlightRing &ring = *rings[i];
+    std::uint64_t head = ring.head.load(std::memory_order_acquire);
+    std::uint64_t events = std::min<std::uint64_t>(head, FlightRing::kEvents);
+    RingHeader ring_header{ring.thread_id, 0, events};
+    if (!write_all(fd, &ring_header, sizeof(ring_header))) {
+      return false;
+    }
+    // Oldest first: once wrapped, [head % N, N) then [0, head % N).
+    const FlightEvent *data = ring.events.get();
+    std::size_t split = head & (FlightRing::kEvents - 1);
+    constexpr std::size_t kSize = sizeof(FlightEvent);
+    bool ok = head > FlightRing::kEvents
+                  ? write_all(fd, data + split, (FlightRing::kEvents - split) * kSize) &&
+                        write_all(fd, data, split * kSize)
+                  : write_all(fd, data, events * kSize);
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool dump_flight_recorder(const std::string &path) {
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    std::cout << "Failed to open flight recorder dump: " << path << std::endl;
+    return false;
+  }
+  bool ok = dump_flight_recorder(fd);
+  close(fd);
+  return ok;
+}
+
+bool install_flight_recorder_signal(const std::string &path, int signo) {
+  if (path.size() >= sizeof(g_signal_path)) {
+    std::cout << "Flight recorder dump path too long: " << path << std::endl;
+    return false;
+  }
+  std::memcpy(g_signal_path, path.c_str(), path.size() + 1);
+  struct sigaction action {};
+  action.sa_handler = on_signal;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  return sigaction(signo != 0 ? signo : SIGUSR2, &action, nullptr) == 0;
+}
+
+void SpikeDumper::dump(std::uint64_t latency_ns) {
+  std::string path = prefix_ + "." + std::to_string(dumps_++) + ".fr";
+  if (dump_flight_recorder(path)) {
+    std::cout << "Latency spike of " << latency_ns << " ns; flight recorder dumped to " << path
+              << std::endl;
+  }
+}
+
+bool read_flight_dump(const std::string &path, FlightDump &out) {
+  std::ifstream in(path, std::ios::binary);
+  DumpHeader header{};
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    std::cout << "Not a flight recorder dump: " << path << std::endl;
+    return false;
+  }
+  if (header.version != kVersion) {
+    std::cout << "Unsupported flight recorder dump version " << header.version << std::endl;
+    return false;
+  }
+  out.ns_per_tick = header.ns_per_tick;
+  out.threads.clear();
+  for (std::uint32_t i = 0; i < header.rings; ++i) {
+    RingHeader ring{};
+    if (!in.read(reinterpret_cast<char *>(&ring), sizeof(ring)) ||
+        ring.events > FlightRing::kEvents) {
+      std::cout << "Truncated flight recorder dump: " << path << std::endl;
+      return false;
+    }
+    FlightDump::Thread &thread = out.threads.emplace_back();
+    thread.thread_id = ring.thread_id;
+    thread.events.resize(ring.events);
+    if (!in.read(reinterpret_cast<char *>(thread.events.data()),
+                 static_cast<std::streamsize>(ring.events * sizeof(FlightEvent)))) {
+      std::cout << "Truncated flight recorder dump: " << path << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace fm
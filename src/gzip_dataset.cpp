@@ -0,0 +1,211 @@
+#include "flashmatch/gzip_dataset.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "lock_free_queue/lock_free_queue.hpp"
+
+namespace fm {
+
+namespace {
+
+// Inflates a gzip file, including files made of several concatenated gzip
+// members. Input is fed to zlib in pieces because avail_in is 32-bit.
+class Inflater {
+public:
+  explicit Inflater(std::string_view input) : rest_(input) {
+    std::memset(&stream_, 0, sizeof(stream_));
+    // 15 window bits + 32 lets zlib detect the gzip header itself.
+    ok_ = inflateInit2(&stream_, 15 + 32) == Z_OK;
+  }
+  ~Inflater() { inflateEnd(&stream_); }
+
+  Inflater(const Inflater &) = delete;
+  Inflater &operator=(const Inflater &) = delete;
+
+  // Appends up to max_bytes of decompressed output to out. Returns false on a
+  // corrupt or truncated stream.
+  bool read(std::string &out, std::size_t max_bytes) {
+    if (!ok_) {
+      return false;
+    }
+    const std::size_t old_size = out.size();
+    out.resize(old_size + max_bytes);
+    stream_.next_out = reinterpret_cast<Bytef *>(out.data() + old_size);
+    stream_.avail_out = static_cast<uInt>(max_bytes);
+
+    while (stream_.avail_out > 0 && !done_) {
+      if (stream_.avail_in == 0) {
+        refill();
+      }
+      int rc = inflate(&stream_, Z_NO_FLUSH);
+      if (rc == Z_STREAM_END) {
+        if (stream_.avail_in == 0 && rest_.empty()) {
+          done_ = true;
+        } else if (inflateReset(&stream_) != Z_OK) {
+          ok_ = false;
+        }
+      } else if (rc == Z_BUF_ERROR && stream_.avail_in == 0 && rest_.empty()) {
+        // Input exhausted before the end of the gzip member.
+        ok_ = false;
+      } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+        ok_ = false;
+      }
+      if (!ok_) {
+        break;
+      }
+    }
+    out.resize(old_size + (max_bytes - stream_.avail_out));
+    return ok_;
+  }
+
+  bool done() const { return done_; }
+
+private:
+  void refill() {
+    std::size_t n = std::min<std::size_t>(rest_.size(), std::numeric_limits<uInt>::max() / 2);
+    stream_.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(rest_.data()));
+    stream_.avail_in = static_cast<uInt>(n);
+    rest_.remove_prefix(n);
+  }
+
+  z_stream stream_;
+  std::string_view rest_;
+  bool ok_ = false;
+  bool done_ = false;
+};
+
+struct Block {
+  std::vector<Order> orders;
+  std::size_t count = 0;
+  bool failed = false;
+  std::string error_line;
+};
+
+} // namespace
+
+bool is_gzip_dataset(std::string_view data) {
+  return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f &&
+         static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+bool GzipOrderStream::read_header(DatasetHeader &out) const {
+  Inflater inflater(compressed_);
+  std::string text;
+  while (text.find('\n') == std::string::npos && !inflater.done()) {
+    if (!inflater.read(text, 4096)) {
+      return false;
+    }
+  }
+  return parse_dataset_header(std::string_view(text).substr(0, text.find('\n')), out);
+}
+
+bool GzipOrderStream::for_each_batch(const OrderBatchSink &sink, std::string &error_line) const {
+  constexpr std::size_t kEndOfStream = std::numeric_limits<std::size_t>::max();
+
+  std::array<Block, kBlocksInFlight> blocks;
+  // Slot indices travel producer -> consumer through filled and back
+  // through free_slots; one extra entry leaves room for kEndOfStream.
+  lfq::Atomic_Queue<std::size_t> filled(kBlocksInFlight + 1);
+  lfq::Atomic_Queue<std::size_t> free_slots(kBlocksInFlight);
+  for (std::size_t i = 0; i < kBlocksInFlight; ++i) {
+    free_slots.push(i);
+  }
+  std::atomic<bool> stop{false};
+  std::string stream_error;
+
+  std::thread producer([&] {
+    Inflater inflater(compressed_);
+    std::string text;
+    bool header_skipped = false;
+    RowFormat format = RowFormat::Csv;
+    while (!stop.load(std::memory_order_relaxed)) {
+      if (!inflater.read(text, kBlockBytes)) {
+        stream_error = "corrupt or truncated gzip stream";
+        break;
+      }
+      if (!header_skipped) {
+        auto eol = text.find('\n');
+        if (eol == std::string::npos && !inflater.done()) {
+          continue;
+        }
+        text.erase(0, eol == std::string::npos ? text.size() : eol + 1);
+        format = detect_row_format(text);
+        header_skipped = true;
+      }
+      // Hand off only whole rows; the partial last row waits for more input.
+      std::size_t usable = text.size();
+      if (!inflater.done()) {
+        auto eol = text.rfind('\n');
+        usable = (eol == std::string::npos) ? 0 : eol + 1;
+      }
+      if (usable > 0) {
+        while (free_slots.isEmpty()) {
+          if (stop.load(std::memory_order_relaxed)) {
+            break;
+          }
+          std::this_thread::yield();
+        }
+        if (stop.load(std::memory_order_relaxed)) {
+          break;
+        }
+        std::size_t slot = free_slots.pop();
+        Block &block = blocks[slot];
+        block.failed = !parse_rows(std::string_view(text.data(), usable),
+                                   format,
+                                   block.orders,
+                                   block.count,
+                                   block.error_line);
+        const bool failed = block.failed;
+        text.erase(0, usable);
+        filled.push(slot);
+        if (failed) {
+          break;
+        }
+      }
+      if (inflater.done()) {
+        break;
+      }
+    }
+    filled.push(kEndOfStream);
+  });
+
+  bool ok = true;
+  while (true) {
+    while (filled.isEmpty()) {
+      std::this_thread::yield();
+    }
+    std::size_t slot = filled.pop();
+    if (slot == kEndOfStream) {
+      if (!stream_error.empty()) {
+        error_line = stream_error;
+        ok = false;
+      }
+      break;
+    }
+    Block &block = blocks[slot];
+    if (block.count > 0 &&
+        !sink(std::span<const Order>(block.orders.data(), block.count))) {
+      stop.store(true, std::memory_order_relaxed);
+      break;
+    }
+    if (block.failed) {
+      error_line = block.error_line;
+      ok = false;
+      stop.store(true, std::memory_order_relaxed);
+      break;
+    }
+    free_slots.push(slot);
+  }
+  producer.join();
+  return ok;
+}
+
+} // namespace fm
@@ -0,0 +1,210 @@
+#include "flashmatch/high_perf_csv_parser.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <system_error>
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#endif
+
+namespace fm {
+
+namespace {
+
+// Every double in this table is exact, so mantissa / kPow10[n] rounds once.
+constexpr std::array<double, 23> kPow10 = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Largest mantissa a double represents exactly.
+constexpr std::uint64_t kMaxExactMantissa = std::uint64_t{1} << 53;
+
+DelimiterMask classify_scalar(const char *p, std::size_t n) {
+  DelimiterMask mask{0, 0};
+  for (std::size_t i = 0; i < n; ++i) {
+    mask.commas |= static_cast<std::uint32_t>(p[i] == ',') << i;
+    mask.newlines |= static_cast<std::uint32_t>(p[i] == '\n') << i;
+  }
+  return mask;
+}
+
+bool parse_uint(std::string_view text, std::uint64_t &out) {
+  const char *last = text.data() + text.size();
+  auto [ptr, ec] = std::from_chars(text.data(), last, out);
+  return ec == std::errc() && ptr == last;
+}
+
+bool parse_fields(const std::array<std::string_view, 6> &fields, Order &out) {
+  if (!parse_uint(fields[0], out.id)) {
+    return false;
+  }
+  out.symbol.assign(fields[1]);
+  out.symbol_hash = 0;
+  out.side = (fields[2] == "BUY") ? Side::BUY : Side::SELL;
+  if (!parse_price(fields[3], out.price)) {
+    return false;
+  }
+  if (!parse_uint(fields[4], out.quantity)) {
+    return false;
+  }
+  out.type = (fields[5] == "IOC") ? OrderType::IOC : OrderType::LIMIT;
+  return true;
+}
+
+} // namespace
+
+DelimiterMask classify_block(const char *p) {
+#if defined(__AVX2__)
+  __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  __m256i commas = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(','));
+  __m256i newlines = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'));
+  return {static_cast<std::uint32_t>(_mm256_movemask_epi8(commas)),
+          static_cast<std::uint32_t>(_mm256_movemask_epi8(newlines))};
+#elif defined(__SSE2__)
+  __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16));
+  __m128i comma = _mm_set1_epi8(',');
+  __m128i newline = _mm_set1_epi8('\n');
+  auto commas_lo = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, comma)));
+  auto commas_hi = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, comma)));
+  auto newlines_lo = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(lo, newline)));
+  auto newlines_hi = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, newline)));
+  return {commas_lo | (commas_hi << 16), newlines_lo | (newlines_hi << 16)};
+#else
+  return classify_scalar(p, 32);
+#endif
+}
+
+const char *csv_kernel_name() {
+#if defined(__AVX2__)
+  return "avx2";
+#elif defined(__SSE2__)
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
+
+bool parse_price(std::string_view text, double &out) {
+  const char *p = text.data();
+  const char *end = p + text.size();
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  std::uint64_t mantissa = 0;
+  std::size_t digits = 0;
+  std::size_t scale = 0;
+  while (p != end && static_cast<unsigned char>(*p - '0') < 10) {
+    mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+    ++digits;
+    ++p;
+  }
+  if (p != end && *p == '.') {
+    ++p;
+    while (p != end && static_cast<unsigned char>(*p - '0') < 10) {
+      mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+      ++digits;
+      ++scale;
+      ++p;
+    }
+  }
+
+  // 19 digits cannot overflow a uint64_t; anything longer, any exponent and
+  // any mantissa a double cannot hold exactly takes the general path.
+  if (digits == 0 || p != end || digits > 19 || scale >= kPow10.size() ||
+      mantissa > kMaxExactMantissa) {
+    const char *first = text.data();
+    const char *last = first + text.size();
+    if (first != last && *first == '+') {
+      ++first;
+    }
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    return ec == std::errc() && ptr == last && first != last;
+  }
+
+  double value = static_cast<double>(mantissa) / kPow10[scale];
+  out = negative ? -value : value;
+  return true;
+}
+
+bool parse_order_line(std::string_view line, Order &out) {
+  CsvOrderScanner scanner(line.data(), line.data() + line.size());
+  return scanner.next(out);
+}
+
+CsvOrderScanner::CsvOrderScanner(const char *begin, const char *end)
+    : cursor_(begin), end_(end), block_(begin) {
+  load_block();
+}
+
+void CsvOrderScanner::load_block() {
+  if (block_ >= end_) {
+    mask_ = 0;
+    return;
+  }
+  auto remaining = static_cast<std::size_t>(end_ - block_);
+  DelimiterMask mask = remaining >= 32 ? classify_block(block_)
+                                       : classify_scalar(block_, remaining);
+  mask_ = mask.commas | mask.newlines;
+}
+
+const char *CsvOrderScanner::next_delimiter() {
+  while (mask_ == 0) {
+    if (end_ - block_ <= 32) {
+      return end_;
+    }
+    block_ += 32;
+    load_block();
+  }
+  const char *delim = block_ + __builtin_ctz(mask_);
+  mask_ &= mask_ - 1;
+  return delim;
+}
+
+bool CsvOrderScanner::next(Order &out) {
+  std::array<std::string_view, 6> fields;
+  while (cursor_ < end_) {
+    const char *row = cursor_;
+    const char *field = row;
+    std::size_t commas = 0;
+    const char *delim = next_delimiter();
+    while (delim != end_ && *delim == ',') {
+      if (commas < 5) {
+        fields[commas] = std::string_view(field, static_cast<std::size_t>(delim - field));
+      }
+      ++commas;
+      field = delim + 1;
+      delim = next_delimiter();
+    }
+    cursor_ = (delim == end_) ? end_ : delim + 1;
+
+    const char *row_end = delim;
+    if (row_end != row && row_end[-1] == '\r') {
+      --row_end;
+    }
+    line_ = std::string_view(row, static_cast<std::size_t>(row_end - row));
+    if (line_.empty()) {
+      continue;
+    }
+    if (commas != 5) {
+      failed_ = true;
+      return false;
+    }
+    fields[5] = std::string_view(field, static_cast<std::size_t>(row_end - field));
+    if (!parse_fields(fields, out)) {
+      failed_ = true;
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+} // namespace fm
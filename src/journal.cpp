@@ -0,0 +1,279 @@
+#include "flashmatch/journal.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include "flashmatch/mapped_file.hpp"
+
+namespace fm {
+
+namespace {
+
+// How long the journal thread sleeps when the queue is empty.
+constexpr std::chrono::microseconds kIdleSleep{20};
+
+std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+
+std::uint32_t record_crc(JournalRecord record, std::string_view symbol) {
+  record.crc32 = 0;
+  uLong crc = crc32_z(0, reinterpret_cast<const Bytef *>(&record), sizeof(record));
+  crc = crc32_z(crc, reinterpret_cast<const Bytef *>(symbol.data()), symbol.size());
+  return static_cast<std::uint32_t>(crc);
+}
+
+bool write_fully(int fd, const char *data, std::size_t size) {
+  while (size > 0) {
+    ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+
+} // namespace
+
+bool JournalReader::open(std::string_view data) {
+  JournalHeader header;
+  if (data.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (std::memcmp(header.magic, kJournalMagic, sizeof(kJournalMagic)) != 0 ||
+      header.version != kJournalVersion) {
+    return false;
+  }
+  data_ = data;
+  offset_ = sizeof(header);
+  last_sequence_ = 0;
+  return true;
+}
+
+std::size_t JournalReader::intact_size(std::size_t offset, std::uint64_t previous,
+                                       JournalRecord &record) const {
+  if (data_.size() - offset < sizeof(record)) {
+    return 0;
+  }
+  std::memcpy(&record, data_.data() + offset, sizeof(record));
+  const std::size_t size = sizeof(record) + padded(record.symbol_length);
+  if (data_.size() - offset < size || (previous != 0 && record.sequence != previous + 1) ||
+      record.side > static_cast<std::uint8_t>(Side::SELL) ||
+      record.type > static_cast<std::uint8_t>(OrderType::IOC)) {
+    return 0;
+  }
+  std::string_view symbol = data_.substr(offset + sizeof(record), record.symbol_length);
+  return record_crc(record, symbol) == record.crc32 ? size : 0;
+}
+
+bool JournalReader::next(std::uint64_t &sequence, Order &out) {
+  JournalRecord record;
+  const std::size_t size = intact_size(offset_, last_sequence_, record);
+  if (size == 0) {
+    return false;
+  }
+  out.id = record.id;
+  out.symbol.assign(data_.substr(offset_ + sizeof(record), record.symbol_length));
+  out.symbol_hash = 0;
+  out.side = static_cast<Side>(record.side);
+  out.price = record.price;
+  out.quantity = record.quantity;
+  out.type = static_cast<OrderType>(record.type);
+  sequence = record.sequence;
+  last_sequence_ = record.sequence;
+  offset_ += size;
+  return true;
+}
+
+std::size_t JournalReader::verify() {
+  std::size_t count = 0;
+  JournalRecord record;
+  while (const std::size_t size = intact_size(offset_, last_sequence_, record)) {
+    last_sequence_ = record.sequence;
+    offset_ += size;
+    ++count;
+  }
+  return count;
+}
+
+std::size_t JournalReader::skip_through(std::uint64_t sequence) {
+  std::size_t skipped = 0;
+  JournalRecord record;
+  while (data_.size() - offset_ >= sizeof(record)) {
+    std::memcpy(&record, data_.data() + offset_, sizeof(record));
+    const std::size_t size = sizeof(record) + padded(record.symbol_length);
+    if (record.sequence > sequence || data_.size() - offset_ < size ||
+        (last_sequence_ != 0 && record.sequence != last_sequence_ + 1)) {
+      break;
+    }
+    last_sequence_ = record.sequence;
+    offset_ += size;
+    ++skipped;
+  }
+  return skipped;
+}
+
+bool JournalReader::torn_tail() const {
+  // Records start 8-byte aligned, so only those offsets can hold one.
+  JournalRecord record;
+  for (std::size_t offset = offset_; data_.size() - offset >= sizeof(record); offset += 8) {
+    if (intact_size(offset, 0, record) != 0 && record.sequence > last_sequence_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Journal::Journal(const std::string &path, std::uint64_t last_sequence, JournalOptions options)
+    : options_(std::move(options)), last_sequence_(last_sequence),
+      queue_(std::max<std::size_t>(options_.queue_capacity, 1)),
+      encoded_sequence_(last_sequence), durable_(last_sequence) {
+  // With 0 the journal thread would never drain the queue.
+  options_.group_commit_orders = std::max<std::size_t>(options_.group_commit_orders, 1);
+  // Find the end of the last intact record of an existing journal.
+  std::size_t valid_bytes = 0;
+  {
+    MappedFile existing(path);
+    if (existing.is_open() && existing.size() > 0) {
+      JournalReader reader;
+      if (!reader.open(existing.view())) {
+        error_ = "not a journal: " + path;
+        return;
+      }
+      reader.verify();
+      if (!reader.at_end() && !reader.torn_tail()) {
+        // Truncating here would drop records that were synced and acked.
+        error_ = "journal " + path + " is damaged at byte " + std::to_string(reader.offset());
+        return;
+      }
+      if (reader.last_sequence() != 0 && reader.last_sequence() != last_sequence) {
+        error_ = "journal " + path + " ends at sequence " +
+                 std::to_string(reader.last_sequence()) + ", expected " +
+                 std::to_string(last_sequence);
+        return;
+      }
+      valid_bytes = reader.offset();
+    }
+  }
+
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    error_ = path + ": " + std::strerror(errno);
+    return;
+  }
+  bool ready;
+  if (valid_bytes == 0) {
+    JournalHeader header{};
+    std::memcpy(header.magic, kJournalMagic, sizeof(kJournalMagic));
+    header.version = kJournalVersion;
+    ready = ::ftruncate(fd_, 0) == 0 &&
+            write_fully(fd_, reinterpret_cast<const char *>(&header), sizeof(header)) &&
+            ::fdatasync(fd_) == 0;
+  } else {
+    // Drops an unsynced tail left by a crash, so appends follow the last
+    // good record.
+    ready = ::ftruncate(fd_, static_cast<off_t>(valid_bytes)) == 0 &&
+            ::lseek(fd_, 0, SEEK_END) >= 0;
+  }
+  if (!ready) {
+    error_ = path + ": " + std::strerror(errno);
+    return;
+  }
+  running_ = true;
+  thread_ = std::thread([this] { loop(); });
+}
+
+Journal::~Journal() {
+  if (thread_.joinable()) {
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+bool Journal::wait_durable(std::uint64_t sequence) const {
+  while (durable_sequence() < sequence) {
+    if (failed() || !running_) {
+      return false;
+    }
+    std::this_thread::sleep_for(kIdleSleep);
+  }
+  return true;
+}
+
+void Journal::loop() {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point oldest{};
+  while (true) {
+    // Read before draining: everything appended before stop was set is
+    // then seen by the drain below.
+    const bool stopping = stop_.load(std::memory_order_acquire);
+    bool drained = false;
+    while (waiting_ < options_.group_commit_orders && !queue_.isEmpty()) {
+      const Order order = queue_.pop();
+      if (waiting_ == 0) {
+        oldest = Clock::now();
+      }
+      // append() refused longer symbols.
+      const auto length = static_cast<std::uint16_t>(order.symbol.size());
+      std::string_view symbol(order.symbol);
+      JournalRecord record{++encoded_sequence_,
+                           order.id,
+                           order.price,
+                           order.quantity,
+                           length,
+                           static_cast<std::uint8_t>(order.side),
+                           static_cast<std::uint8_t>(order.type),
+                           0};
+      record.crc32 = record_crc(record, symbol);
+      const char *bytes = reinterpret_cast<const char *>(&record);
+      buffer_.insert(buffer_.end(), bytes, bytes + sizeof(record));
+      buffer_.insert(buffer_.end(), symbol.begin(), symbol.end());
+      buffer_.resize(buffer_.size() + padded(length) - length, '\0');
+      ++waiting_;
+      drained = true;
+    }
+
+    if (waiting_ > 0 && (waiting_ >= options_.group_commit_orders || stopping ||
+                         Clock::now() - oldest >= options_.group_commit_interval)) {
+      if (!commit()) {
+        return;
+      }
+    } else if (stopping && waiting_ == 0) {
+      return;
+    } else if (!drained) {
+      std::this_thread::sleep_for(kIdleSleep);
+    }
+  }
+}
+
+bool Journal::commit() {
+  if (!write_fully(fd_, buffer_.data(), buffer_.size()) || ::fdatasync(fd_) != 0) {
+    std::cout << "Journal write failed: " << std::strerror(errno) << std::endl;
+    failed_.store(true, std::memory_order_release);
+    return false;
+  }
+  buffer_.clear();
+  waiting_ = 0;
+  syncs_.fetch_add(1, std::memory_order_relaxed);
+  durable_.store(encoded_sequence_, std::memory_order_release);
+  if (options_.on_durable) {
+    options_.on_durable(encoded_sequence_);
+  }
+  return true;
+}
+
+} // namespace fm
@@ -0,0 +1,312 @@
+#include "flashmatch/jsonl_order_parser.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <system_error>
+
+#include "flashmatch/high_perf_csv_parser.hpp"
+
+namespace fm {
+
+namespace {
+
+enum Field : unsigned {
+  kUnknown = 0,
+  kId = 1u << 0,
+  kSymbol = 1u << 1,
+  kSide = 1u << 2,
+  kPrice = 1u << 3,
+  kQuantity = 1u << 4,
+  kType = 1u << 5,
+};
+constexpr unsigned kAllFields = kId | kSymbol | kSide | kPrice | kQuantity | kType;
+
+Field field_for(std::string_view key) {
+  switch (key.size()) {
+    case 2:
+      return key == "id" ? kId : kUnknown;
+    case 4:
+      return key == "side" ? kSide : (key == "type" ? kType : kUnknown);
+    case 5:
+      return key == "price" ? kPrice : kUnknown;
+    case 6:
+      return key == "symbol" ? kSymbol : kUnknown;
+    case 8:
+      return key == "quantity" ? kQuantity : kUnknown;
+    default:
+      return kUnknown;
+  }
+}
+
+bool is_number_char(char c) {
+  return static_cast<unsigned char>(c - '0') < 10 || c == '-' || c == '+' || c == '.' ||
+         c == 'e' || c == 'E';
+}
+
+bool parse_uint(std::string_view text, std::uint64_t &out) {
+  const char *last = text.data() + text.size();
+  auto [ptr, ec] = std::from_chars(text.data(), last, out);
+  return ec == std::errc() && ptr == last;
+}
+
+// Matches lit at p and advances past it.
+bool consume(const char *&p, const char *end, std::string_view lit) {
+  if (static_cast<std::size_t>(end - p) < lit.size() ||
+      std::memcmp(p, lit.data(), lit.size()) != 0) {
+    return false;
+  }
+  p += lit.size();
+  return true;
+}
+
+std::string_view number_token(const char *&p, const char *end) {
+  const char *begin = p;
+  while (p < end && is_number_char(*p)) {
+    ++p;
+  }
+  return std::string_view(begin, static_cast<std::size_t>(p - begin));
+}
+
+// Reads an unescaped string body up to its closing quote.
+bool plain_string(const char *&p, const char *end, std::string_view &out) {
+  const char *begin = p;
+  while (p < end && *p != '"' && *p != '\\') {
+    ++p;
+  }
+  if (p >= end || *p != '"') {
+    return false;
+  }
+  out = std::string_view(begin, static_cast<std::size_t>(p - begin));
+  ++p;
+  return true;
+}
+
+} // namespace
+
+void JsonOrderScanner::skip_whitespace() {
+  while (cursor_ < end_ &&
+         (*cursor_ == ' ' || *cursor_ == '\n' || *cursor_ == '\r' || *cursor_ == '\t')) {
+    ++cursor_;
+  }
+}
+
+bool JsonOrderScanner::parse_string(std::string_view &out) {
+  if (cursor_ >= end_ || *cursor_ != '"') {
+    return false;
+  }
+  const char *begin = ++cursor_;
+  const void *quote = std::memchr(begin, '"', static_cast<std::size_t>(end_ - begin));
+  if (quote == nullptr) {
+    return false;
+  }
+  const char *close = static_cast<const char *>(quote);
+  if (std::memchr(begin, '\\', static_cast<std::size_t>(close - begin)) == nullptr) {
+    out = std::string_view(begin, static_cast<std::size_t>(close - begin));
+    cursor_ = close + 1;
+    return true;
+  }
+
+  // Slow path for escaped strings, e.g. pandas writes '/' as "\/".
+  unescaped_.clear();
+  while (cursor_ < end_ && *cursor_ != '"') {
+    char c = *cursor_++;
+    if (c != '\\') {
+      unescaped_.push_back(c);
+      continue;
+    }
+    if (cursor_ >= end_) {
+      return false;
+    }
+    switch (*cursor_++) {
+      case '"':
+        unescaped_.push_back('"');
+        break;
+      case '\\':
+        unescaped_.push_back('\\');
+        break;
+      case '/':
+        unescaped_.push_back('/');
+        break;
+      case 'b':
+        unescaped_.push_back('\b');
+        break;
+      case 'f':
+        unescaped_.push_back('\f');
+        break;
+      case 'n':
+        unescaped_.push_back('\n');
+        break;
+      case 'r':
+        unescaped_.push_back('\r');
+        break;
+      case 't':
+        unescaped_.push_back('\t');
+        break;
+      default:
+        // \u escapes never occur in order fields.
+        return false;
+    }
+  }
+  if (cursor_ >= end_) {
+    return false;
+  }
+  ++cursor_;
+  out = unescaped_;
+  return true;
+}
+
+bool JsonOrderScanner::parse_canonical(Order &out) {
+  const char *p = cursor_;
+  std::string_view value;
+  if (!consume(p, end_, R"({"id":)") || !parse_uint(number_token(p, end_), out.id)) {
+    return false;
+  }
+  if (!consume(p, end_, R"(,"symbol":")") || !plain_string(p, end_, value)) {
+    return false;
+  }
+  out.symbol.assign(value);
+  out.symbol_hash = 0;
+  if (!consume(p, end_, R"(,"side":")") || !plain_string(p, end_, value)) {
+    return false;
+  }
+  out.side = (value == "BUY") ? Side::BUY : Side::SELL;
+  if (!consume(p, end_, R"(,"price":)") || !parse_price(number_token(p, end_), out.price)) {
+    return false;
+  }
+  if (!consume(p, end_, R"(,"quantity":)") ||
+      !parse_uint(number_token(p, end_), out.quantity)) {
+    return false;
+  }
+  if (!consume(p, end_, R"(,"type":")") || !plain_string(p, end_, value)) {
+    return false;
+  }
+  out.type = (value == "IOC") ? OrderType::IOC : OrderType::LIMIT;
+  if (!consume(p, end_, "}")) {
+    return false;
+  }
+  cursor_ = p;
+  return true;
+}
+
+bool JsonOrderScanner::parse_object(Order &out) {
+  if (*cursor_ != '{') {
+    return false;
+  }
+  ++cursor_;
+  unsigned seen = 0;
+  while (true) {
+    skip_whitespace();
+    std::string_view key;
+    if (!parse_string(key)) {
+      return false;
+    }
+    const Field field = field_for(key);
+    skip_whitespace();
+    if (cursor_ >= end_ || *cursor_ != ':') {
+      return false;
+    }
+    ++cursor_;
+    skip_whitespace();
+    if (cursor_ >= end_) {
+      return false;
+    }
+
+    if (*cursor_ == '"') {
+      std::string_view value;
+      if (!parse_string(value)) {
+        return false;
+      }
+      switch (field) {
+        case kSymbol:
+          out.symbol.assign(value);
+          out.symbol_hash = 0;
+          break;
+        case kSide:
+          out.side = (value == "BUY") ? Side::BUY : Side::SELL;
+          break;
+        case kType:
+          out.type = (value == "IOC") ? OrderType::IOC : OrderType::LIMIT;
+          break;
+        case kUnknown:
+          break;
+        default:
+          return false;
+      }
+    } else {
+      const char *token = cursor_;
+      while (cursor_ < end_ && is_number_char(*cursor_)) {
+        ++cursor_;
+      }
+      std::string_view number(token, static_cast<std::size_t>(cursor_ - token));
+      bool ok = true;
+      switch (field) {
+        case kId:
+          ok = parse_uint(number, out.id);
+          break;
+        case kPrice:
+          ok = parse_price(number, out.price);
+          break;
+        case kQuantity:
+          ok = parse_uint(number, out.quantity);
+          break;
+        case kUnknown:
+          // Skip numbers and the literals true, false and null.
+          while (cursor_ < end_ && *cursor_ >= 'a' && *cursor_ <= 'z') {
+            ++cursor_;
+          }
+          ok = cursor_ != token;
+          break;
+        default:
+          ok = false;
+          break;
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+    seen |= field;
+
+    skip_whitespace();
+    if (cursor_ >= end_) {
+      return false;
+    }
+    if (*cursor_ == ',') {
+      ++cursor_;
+      continue;
+    }
+    if (*cursor_ == '}') {
+      ++cursor_;
+      break;
+    }
+    return false;
+  }
+  return seen == kAllFields;
+}
+
+bool JsonOrderScanner::next(Order &out) {
+  skip_whitespace();
+  if (cursor_ >= end_) {
+    return false;
+  }
+  const char *start = cursor_;
+  if (parse_canonical(out)) {
+    line_ = std::string_view(start, static_cast<std::size_t>(cursor_ - start));
+    return true;
+  }
+  if (!parse_object(out)) {
+    const void *eol = std::memchr(start, '\n', static_cast<std::size_t>(end_ - start));
+    const char *stop = eol != nullptr ? static_cast<const char *>(eol) : end_;
+    line_ = std::string_view(start, static_cast<std::size_t>(stop - start));
+    failed_ = true;
+    return false;
+  }
+  line_ = std::string_view(start, static_cast<std::size_t>(cursor_ - start));
+  return true;
+}
+
+bool parse_order_json(std::string_view text, Order &out) {
+  JsonOrderScanner scanner(text.data(), text.data() + text.size());
+  return scanner.next(out);
+}
+
+} // namespace fm
@@ -0,0 +1,56 @@
+#include "flashmatch/latency_histogram.hpp"
+
+#include <cmath>
+
+namespace fm {
+
+std::uint64_t LatencyHistogram::bucket_upper_bound(std::size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const std::size_t shift = index / kSubBuckets - 1;
+  const std::uint64_t sub = kSubBuckets + index % kSubBuckets;
+  return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  sum_ = 0;
+  min_ = UINT64_MAX;
+  max_ = 0;
+}
+
+double LatencyHistogram::mean() const {
+  return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_);
+}
+
+std::uint64_t LatencyHistogram::percentile(double percent) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  percent = std::clamp(percent, 0.0, 100.0);
+  auto rank = static_cast<std::uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(count_)));
+  rank = std::clamp<std::uint64_t>(rank, 1, count_);
+
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return std::clamp(bucket_upper_bound(i), min(), max_);
+    }
+  }
+  return max_;
+}
+
+} // namespace fm
@@ -1,26 +1,203 @@
 #include "flashmatch/matching_engine.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
 namespace fm {
 
+namespace {
+
+// Counting sort of orders into out on each symbol's first-appearance index,
+// which keeps arrival order within a symbol. Moves the orders unless they
+// are const. Returns where each group starts in out, then out.size().
+template <typename T>
+std::vector<std::size_t> group_by_symbol(std::span<T> orders, std::vector<Order> &out) {
+  std::unordered_map<std::string_view, std::uint32_t, SymbolHash> groups;
+  std::vector<std::uint32_t> group_of(orders.size());
+  std::vector<std::size_t> offsets(1, 0);
+  for (std::size_t i = 0; i < orders.size(); ++i) {
+    auto [it, inserted] = groups.try_emplace(orders[i].symbol, groups.size());
+    if (inserted) {
+      offsets.push_back(0);
+    }
+    group_of[i] = it->second;
+    ++offsets[it->second + 1];
+  }
+  for (std::size_t g = 1; g < offsets.size(); ++g) {
+    offsets[g] += offsets[g - 1];
+  }
+  out.resize(orders.size());
+  std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+  for (std::size_t i = 0; i < orders.size(); ++i) {
+    if constexpr (std::is_const_v<T>) {
+      out[next[group_of[i]]++] = orders[i];
+    } else {
+      out[next[group_of[i]]++] = std::move(orders[i]);
+    }
+  }
+  return offsets;
+}
+
+} // namespace
+
+AnyOrderBook &MatchingEngine::new_book(std::string_view symbol, std::uint64_t hash,
+                                       Allocation allocation) {
+  AnyOrderBook created;
+  switch (allocation) {
+  case Allocation::Fifo:
+    break;
+  case Allocation::ProRata:
+    created.emplace<ProRataOrderBook>();
+    break;
+  case Allocation::TopOrderProRata:
+    created.emplace<TopOrderProRataOrderBook>();
+    break;
+  }
+  AnyOrderBook *inserted = books_.try_emplace(symbol, hash, std::move(created)).first;
+  std::visit(
+      [&](auto &symbol_book) {
+        symbol_book.attach_metrics(MetricsRegistry::instance().register_book(symbol));
+      },
+      *inserted);
+  return *inserted;
+}
+
+void MatchingEngine::for_each_parallel(std::span<const std::size_t> sizes, std::size_t threads,
+                                       const std::function<void(std::size_t)> &fn) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min(threads, sizes.size());
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+      fn(i);
+    }
+    return;
+  }
+  // Largest first, so a big book is not the last one started.
+  std::vector<std::uint32_t> by_size(sizes.size());
+  std::iota(by_size.begin(), by_size.end(), 0);
+  std::sort(by_size.begin(), by_size.end(),
+            [&](std::uint32_t a, std::uint32_t b) { return sizes[a] > sizes[b]; });
+  std::atomic<std::size_t> next{0};
+  auto worker = [&] {
+    for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < sizes.size();) {
+      fn(by_size[i]);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread &thread : workers) {
+    thread.join();
+  }
+}
+
 void MatchingEngine::insert(const Order &order) {
-  books_[order.symbol].insertOrder(order);
+  MetricsRegistry::add(Counter::OrdersIn);
+  ++sequence_;
+  std::visit([&](auto &symbol_book) { symbol_book.insertOrder(order); }, book(order));
 }
 
-void MatchingEngine::add(const Order &order) { pending_.push(order); }
+void MatchingEngine::bulk_insert(std::span<const Order> orders, std::size_t threads) {
+  MetricsRegistry::add(Counter::OrdersIn, orders.size());
+  sequence_ += orders.size();
+  std::vector<std::size_t> offsets = group_by_symbol(orders, grouped_);
+  const std::size_t groups = offsets.size() - 1;
+  // Books are created here, since that registers metrics and may grow
+  // books_; workers only fill them. Entries never move once created.
+  std::vector<AnyOrderBook *> books(groups);
+  for (std::size_t g = 0; g < groups; ++g) {
+    books[g] = &book(grouped_[offsets[g]]);
+  }
+  std::vector<std::size_t> sizes(groups);
+  for (std::size_t g = 0; g < groups; ++g) {
+    sizes[g] = offsets[g + 1] - offsets[g];
+  }
+  for_each_parallel(sizes, threads, [&](std::size_t g) {
+    std::span<const Order> group(grouped_.data() + offsets[g], sizes[g]);
+    std::visit([&](auto &symbol_book) { symbol_book.bulk_insert(group); }, *books[g]);
+  });
+  grouped_.clear();
+}
+
+void MatchingEngine::add(const Order &order) { pending_.push_back(order); }
+
+void MatchingEngine::add(Order &&order) { pending_.push_back(std::move(order)); }
 
 std::vector<Trade> MatchingEngine::run() {
   std::vector<Trade> all_trades;
-  while (!pending_.empty()) {
-    auto order = pending_.front();
-    pending_.pop();
-    auto trades = submit(order);
-    all_trades.insert(all_trades.end(), trades.begin(), trades.end());
+  MetricsRegistry::add(Counter::OrdersIn, pending_.size());
+  sequence_ += pending_.size();
+  for (Order &order : pending_) {
+    std::visit([&](auto &symbol_book) { symbol_book.match(std::move(order), all_trades); },
+               book(order));
   }
+  pending_.clear();
   return all_trades;
 }
 
+std::vector<Trade> MatchingEngine::run_grouped() {
+  sequence_ += pending_.size();
+  std::vector<std::size_t> offsets = group_by_symbol(std::span<Order>(pending_), grouped_);
+  pending_.clear();
+
+  std::vector<Trade> trades;
+  trades.reserve(grouped_.size());
+  for (std::size_t g = 0; g + 1 < offsets.size(); ++g) {
+    MetricsRegistry::add(Counter::OrdersIn, offsets[g + 1] - offsets[g]);
+    std::visit(
+        [&](auto &symbol_book) {
+          for (std::size_t i = offsets[g]; i < offsets[g + 1]; ++i) {
+            symbol_book.match(std::move(grouped_[i]), trades);
+          }
+        },
+        book(grouped_[offsets[g]]));
+  }
+  grouped_.clear();
+  return trades;
+}
+
 std::vector<Trade> MatchingEngine::submit(const Order &order) {
-  return books_[order.symbol].match(order);
+  MetricsRegistry::add(Counter::OrdersIn);
+  ++sequence_;
+  return std::visit([&](auto &symbol_book) { return symbol_book.match(order); }, book(order));
+}
+
+void MatchingEngine::submit_batch(std::span<const Order> orders, TradeSink &sink) {
+  MetricsRegistry::add(Counter::OrdersIn, orders.size());
+  sequence_ += orders.size();
+  // Consecutive orders often share a symbol; look the book up and dispatch
+  // on its policy once per run of them.
+  std::size_t begin = 0;
+  while (begin < orders.size()) {
+    std::size_t end = begin + 1;
+    while (end < orders.size() && orders[end].symbol == orders[begin].symbol) {
+      ++end;
+    }
+    std::visit(
+        [&](auto &symbol_book) {
+          for (std::size_t i = begin; i < end; ++i) {
+            batch_trades_.clear();
+            symbol_book.match(orders[i], batch_trades_);
+            if (!batch_trades_.empty()) {
+              sink.on_trades(orders[i], batch_trades_);
+            }
+          }
+        },
+        book(orders[begin]));
+    begin = end;
+  }
 }
 
 } // namespace fm
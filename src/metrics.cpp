@@ -0,0 +1,286 @@
+#include "flashmatch/metrics.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace fm {
+
+const char *counter_name(Counter counter) {
+  switch (counter) {
+  case Counter::OrdersIn:
+    return "orders_in";
+  case Counter::TradesOut:
+    return "trades_out";
+  case Counter::IocRemaindersDropped:
+    return "ioc_remainders_dropped";
+  case Counter::QueuePushes:
+    return "queue_pushes";
+  case Counter::QueuePushFailures:
+    return "queue_push_failures";
+  }
+  return "unknown";
+}
+
+// Hands the calling thread's slot back to the registry when the thread exits.
+struct SlotReleaser {
+  MetricsRegistry *registry = nullptr;
+  CounterSlot *slot = nullptr;
+  ~SlotReleaser() {
+    if (registry != nullptr) {
+      MetricsRegistry::local_slot_ = nullptr;
+      registry->release(slot);
+    }
+  }
+};
+
+void BookGaugesRelease::operator()(BookGauges *gauges) const {
+  registry->release(gauges);
+}
+
+MetricsRegistry &MetricsRegistry::instance() {
+  // Never destroyed: threads and books may outlive static destruction order.
+  static MetricsRegistry *registry = new MetricsRegistry();
+  return *registry;
+}
+
+CounterSlot *MetricsRegistry::attach_thread() {
+  CounterSlot *slot;
+  {
+    std::lock_guard lock(mutex_);
+    if (free_slots_.empty()) {
+      slot = &slots_.emplace_back();
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+  }
+  thread_local SlotReleaser releaser;
+  releaser.registry = this;
+  releaser.slot = slot;
+  local_slot_ = slot;
+  return slot;
+}
+
+void MetricsRegistry::release(CounterSlot *slot) {
+  std::lock_guard lock(mutex_);
+  free_slots_.push_back(slot);
+}
+
+BookGaugesHandle MetricsRegistry::register_book(std::string_view symbol) {
+  std::lock_guard lock(mutex_);
+  BookGauges *gauges;
+  if (free_books_.empty()) {
+    gauges = &books_.emplace_back();
+  } else {
+    gauges = free_books_.back();
+    free_books_.pop_back();
+  }
+  gauges->symbol.assign(symbol);
+  gauges->in_use = true;
+  return BookGaugesHandle(gauges, BookGaugesRelease{this});
+}
+
+void MetricsRegistry::release(BookGauges *gauges) {
+  std::lock_guard lock(mutex_);
+  gauges->levels.store(0, std::memory_order_relaxed);
+  gauges->orders.store(0, std::memory_order_relaxed);
+  gauges->in_use = false;
+  free_books_.push_back(gauges);
+}
+
+std::size_t MetricsRegistry::add_gauge(std::string name, std::function<std::int64_t()> sample) {
+  std::lock_guard lock(mutex_);
+  gauges_.push_back({next_gauge_id_, std::move(name), std::move(sample)});
+  return next_gauge_id_++;
+}
+
+void MetricsRegistry::remove_gauge(std::size_t id) {
+  std::lock_guard lock(mutex_);
+  std::erase_if(gauges_, [id](const Gauge &gauge) { return gauge.id == id; });
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+  MetricsSnapshot snapshot;
+  snapshot.time = std::chrono::system_clock::now();
+  std::lock_guard lock(mutex_);
+  for (const CounterSlot &slot : slots_) {
+    for (std::size_t i = 0; i < kCounterCount; ++i) {
+      snapshot.counters[i] += slot.values[i].load(std::memory_order_relaxed);
+    }
+  }
+  std::map<std::string_view, SymbolMetrics> symbols;
+  for (const BookGauges &book : books_) {
+    if (!book.in_use) {
+      continue;
+    }
+    SymbolMetrics &entry = symbols[book.symbol];
+    entry.levels += book.levels.load(std::memory_order_relaxed);
+    entry.orders += book.orders.load(std::memory_order_relaxed);
+  }
+  snapshot.symbols.reserve(symbols.size());
+  for (auto &[symbol, entry] : symbols) {
+    entry.symbol = symbol;
+    snapshot.symbols.push_back(std::move(entry));
+  }
+  for (const Gauge &gauge : gauges_) {
+    snapshot.gauges.emplace_back(gauge.name, gauge.sample());
+  }
+  return snapshot;
+}
+
+void write_prometheus(std::ostream &out, const MetricsSnapshot &snapshot) {
+  for (std::size_t i = 0; i < kCounterCount; ++i) {
+    const char *name = counter_name(static_cast<Counter>(i));
+    out << "# TYPE flashmatch_" << name << "_total counter\n"
+        << "flashmatch_" << name << "_total " << snapshot.counters[i] << "\n";
+  }
+  out << "# TYPE flashmatch_book_levels gauge\n";
+  for (const SymbolMetrics &entry : snapshot.symbols) {
+    out << "flashmatch_book_levels{symbol=\"" << entry.symbol << "\"} " << entry.levels << "\n";
+  }
+  out << "# TYPE flashmatch_book_orders gauge\n";
+  for (const SymbolMetrics &entry : snapshot.symbols) {
+    out << "flashmatch_book_orders{symbol=\"" << entry.symbol << "\"} " << entry.orders << "\n";
+  }
+  for (const auto &[name, value] : snapshot.gauges) {
+    out << "# TYPE flashmatch_" << name << " gauge\n"
+        << "flashmatch_" << name << " " << value << "\n";
+  }
+}
+
+MetricsExporter::MetricsExporter(ExporterOptions options, MetricsRegistry &registry)
+    : options_(std::move(options)), registry_(registry) {
+  if (pipe(wake_fds_) != 0) {
+    error_ = std::string("pipe: ") + std::strerror(errno);
+    return;
+  }
+  if (options_.http_port >= 0) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<std::uint16_t>(options_.http_port));
+    socklen_t len = sizeof(addr);
+    if (listen_fd_ < 0 || bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), len) != 0 ||
+        listen(listen_fd_, 16) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len) != 0) {
+      error_ = "metrics port " + std::to_string(options_.http_port) + ": " +
+               std::strerror(errno);
+      if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+      }
+    } else {
+      port_ = ntohs(addr.sin_port);
+    }
+  }
+  thread_ = std::thread([this] { loop(); });
+}
+
+MetricsExporter::~MetricsExporter() {
+  if (thread_.joinable()) {
+    char stop = 0;
+    ssize_t written = write(wake_fds_[1], &stop, 1);
+    (void)written;
+    thread_.join();
+  }
+  for (int fd : {listen_fd_, wake_fds_[0], wake_fds_[1]}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+void MetricsExporter::loop() {
+  using Clock = std::chrono::steady_clock;
+  auto next = Clock::now();
+  while (true) {
+    auto now = Clock::now();
+    if (now >= next) {
+      if (!options_.text_path.empty()) {
+        std::ostringstream text;
+        write_prometheus(text, registry_.snapshot());
+        export_file(text.str());
+      }
+      next = now + options_.interval;
+    }
+    pollfd fds[2] = {{wake_fds_[0], POLLIN, 0}, {listen_fd_, POLLIN, 0}};
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now());
+    int timeout = static_cast<int>(std::max<std::int64_t>(wait.count(), 0));
+    int ready = poll(fds, listen_fd_ >= 0 ? 2 : 1, timeout);
+    if (ready < 0 && errno != EINTR) {
+      return;
+    }
+    if (fds[0].revents != 0) {
+      return;
+    }
+    if (listen_fd_ >= 0 && (fds[1].revents & POLLIN) != 0) {
+      int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+      if (client >= 0) {
+        serve(client);
+        close(client);
+      }
+    }
+  }
+}
+
+void MetricsExporter::export_file(const std::string &text) const {
+  // Write then rename so readers never see a partial file.
+  std::string tmp = options_.text_path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    out << text;
+    if (!out) {
+      return;
+    }
+  }
+  std::rename(tmp.c_str(), options_.text_path.c_str());
+}
+
+void MetricsExporter::serve(int client) const {
+  timeval timeout{0, 200'000};
+  setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  char request[1024];
+  ssize_t n = recv(client, request, sizeof(request) - 1, 0);
+  if (n <= 0) {
+    return;
+  }
+  request[n] = '\0';
+  std::string_view line(request, static_cast<std::size_t>(n));
+  bool found = line.starts_with("GET /metrics ") || line.starts_with("GET / ");
+
+  std::string body;
+  if (found) {
+    std::ostringstream text;
+    write_prometheus(text, registry_.snapshot());
+    body = text.str();
+  } else {
+    body = "not found\n";
+  }
+  std::string response = found ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n";
+  response += "Content-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+              std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+  std::size_t sent = 0;
+  while (sent < response.size()) {
+    ssize_t w = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+    if (w <= 0) {
+      return;
+    }
+    sent += static_cast<std::size_t>(w);
+  }
+}
+
+} // namespace fm
@@ -1,75 +1,198 @@
 #include "flashmatch/order_book.hpp"
-// #include <algorithm>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "flashmatch/flight_recorder.hpp"
 
 namespace fm {
 
-void OrderBook::insertOrder(const Order &order) {
+template <typename Allocation>
+void BasicOrderBook<Allocation>::insertOrder(const Order &order) {
+  FlightRecorder::stamp();
   if (order.side == Side::BUY) {
-    bids_[order.price].push_back(order);
+    rest<Side::BUY>(order);
   } else {
-    asks_[order.price].push_back(order);
+    rest<Side::SELL>(order);
   }
 }
 
-std::vector<Trade> OrderBook::match(Order order) {
-  std::vector<Trade> trades;
-  // If order is to buy.
-  if (order.side == Side::BUY) {
-    while (order.quantity > 0 && !asks_.empty()) {
-      auto it = asks_.begin();
-      // To check if buyer's price is more than the lowest the seller is
-      // selling. Now since in the map it is ordered from lowest to largest the
-      // first value is automatically the lowest price asked by the seller to
-      // sell.
-      if (it->first > order.price)
-        break;
+template <typename Allocation>
+template <Side S>
+void BasicOrderBook<Allocation>::rest(const Order &order) {
+  auto [it, created] = levels<S>().try_emplace(order.price);
+  it->second.orders.push_back(order);
+  if constexpr (Allocation::kTopOrder) {
+    if (created && it == levels<S>().begin()) {
+      it->second.top_order_live = true;
+    }
+  }
+  FlightRecorder::record(FlightEventType::Rested, order, order.quantity, order.price);
+  if (created) {
+    FlightRecorder::record(FlightEventType::LevelCreated, order, 0, order.price);
+  }
+  ++live_orders_;
+  publish();
+}
 
-      auto &deque = it->second;
-      while (order.quantity > 0 && !deque.empty()) {
-        Order &order_seller = deque.front();
-        std::uint64_t traded = std::min(order.quantity, order_seller.quantity);
-        trades.push_back(
-            Trade{order_seller.id, order.id, order_seller.price, traded});
-        order.quantity -= traded;
-        order_seller.quantity -= traded;
-        if (order_seller.quantity == 0) {
-          deque.pop_front();
-        }
-      }
-      if (deque.empty()) {
-        asks_.erase(it);
+template <typename Allocation>
+void BasicOrderBook<Allocation>::bulk_insert(std::span<const Order> orders) {
+  std::vector<const Order *> buys, sells;
+  for (const Order &order : orders) {
+    (order.side == Side::BUY ? buys : sells).push_back(&order);
+  }
+  bulk_rest<Side::BUY>(buys);
+  bulk_rest<Side::SELL>(sells);
+  live_orders_ += static_cast<std::int64_t>(orders.size());
+  publish();
+}
+
+template <typename Allocation>
+template <Side S>
+void BasicOrderBook<Allocation>::bulk_rest(std::vector<const Order *> &orders) {
+  if (orders.empty()) {
+    return;
+  }
+  using Compare = typename SideTraits<S>::Compare;
+  const Compare better;
+  auto &book = levels<S>();
+  // Sequential inserts would give a top order to each order that opened a
+  // new best price; find those before sorting loses arrival order.
+  std::vector<double> new_bests;
+  if constexpr (Allocation::kTopOrder) {
+    bool have_best = !book.empty();
+    double best = have_best ? book.begin()->first : 0.0;
+    for (const Order *order : orders) {
+      if (!have_best || better(order->price, best)) {
+        new_bests.push_back(order->price);
+        best = order->price;
+        have_best = true;
       }
     }
+  }
+  std::stable_sort(orders.begin(), orders.end(), [&](const Order *a, const Order *b) {
+    return better(a->price, b->price);
+  });
+  // Prices arrive best first, so each new level belongs just before `hint`
+  // unless an existing level lies in between.
+  auto hint = book.begin();
+  for (std::size_t i = 0; i < orders.size();) {
+    auto it = book.try_emplace(hint, orders[i]->price);
+    auto &level = it->second.orders;
+    do {
+      level.push_back(*orders[i]);
+      ++i;
+    } while (i < orders.size() && orders[i]->price == it->first);
+    hint = std::next(it);
+  }
+  if constexpr (Allocation::kTopOrder) {
+    for (double price : new_bests) {
+      book.find(price)->second.top_order_live = true;
+    }
+  }
+}
+
+template <typename Allocation>
+bool BasicOrderBook<Allocation>::append_level(Side side, double price, PriceLevel level) {
+  auto append = [&](auto &book) {
+    const typename std::decay_t<decltype(book)>::key_compare better;
+    if (!book.empty() && !better(std::prev(book.end())->first, price)) {
+      return false;
+    }
+    live_orders_ += static_cast<std::int64_t>(level.orders.size());
+    book.emplace_hint(book.end(), price, std::move(level));
+    return true;
+  };
+  bool appended = side == Side::BUY ? append(bids_) : append(asks_);
+  publish();
+  return appended;
+}
+
+template <typename Allocation>
+void BasicOrderBook<Allocation>::attach_metrics(BookGaugesHandle gauges) {
+  gauges_ = std::move(gauges);
+  publish();
+}
+
+template <typename Allocation>
+std::vector<Trade> BasicOrderBook<Allocation>::match(Order order) {
+  std::vector<Trade> trades;
+  match(std::move(order), trades);
+  return trades;
+}
+
+template <typename Allocation>
+void BasicOrderBook<Allocation>::match(Order order, std::vector<Trade> &trades) {
+  FlightRecorder::stamp();
+  FlightRecorder::record(FlightEventType::OrderReceived, order, order.quantity, order.price);
+  const std::uint64_t requested = order.quantity;
+  const std::size_t first_trade = trades.size();
+  // The only runtime branch on side and type; everything below is resolved
+  // at compile time.
+  if (order.side == Side::BUY) {
+    if (order.type == OrderType::LIMIT) {
+      match_kernel<Side::BUY, OrderType::LIMIT>(order, trades);
+    } else {
+      match_kernel<Side::BUY, OrderType::IOC>(order, trades);
+    }
   } else {
-    while (order.quantity > 0 && !bids_.empty()) {
-      auto it = bids_.begin();
-      // To check if the seller's ask is greater than the
-      // highest buyer's bid, if so then cancel matching
-      // since than there is no trade to be made.
-      if (order.price > it->first)
-        break;
+    if (order.type == OrderType::LIMIT) {
+      match_kernel<Side::SELL, OrderType::LIMIT>(order, trades);
+    } else {
+      match_kernel<Side::SELL, OrderType::IOC>(order, trades);
+    }
+  }
+  FlightRecorder::stamp();
+  FlightRecorder::record(FlightEventType::Matched, order, requested - order.quantity,
+                         order.price, trades.size() - first_trade);
+}
 
-      auto &deque = it->second;
-      while (order.quantity > 0 && !deque.empty()) {
-        Order &order_buyer = deque.front();
-        std::uint64_t traded = std::min(order.quantity, order_buyer.quantity);
-        trades.push_back(
-            Trade{order_buyer.id, order.id, order_buyer.price, traded});
-        order.quantity -= traded;
-        order_buyer.quantity -= traded;
-        if (order_buyer.quantity == 0) {
-          deque.pop_front();
-        }
-      }
-      if (deque.empty()) {
-        bids_.erase(it);
-      }
+template <typename Allocation>
+template <Side S, OrderType T>
+void BasicOrderBook<Allocation>::match_kernel(Order &order, std::vector<Trade> &trades) {
+  constexpr Side kOpposite = SideTraits<S>::opposite;
+  // Orders the opposite side best first: a level the comparator places
+  // strictly after our limit does not cross it.
+  const typename SideTraits<kOpposite>::Compare ahead;
+  auto &book = levels<kOpposite>();
+  const std::size_t first_trade = trades.size();
+  auto fill = [&](Order &resting, std::uint64_t traded) {
+    trades.push_back(Trade{resting.id, order.id, resting.price, traded});
+    FlightRecorder::record(FlightEventType::Trade, order, traded, resting.price, resting.id);
+    order.quantity -= traded;
+    resting.quantity -= traded;
+  };
+  while (order.quantity > 0 && !book.empty()) {
+    auto it = book.begin();
+    if (ahead(order.price, it->first)) {
+      break;
+    }
+    auto &orders = it->second.orders;
+    const std::size_t resting = orders.size();
+    allocation_.allocate(it->second, order.quantity, fill);
+    live_orders_ -= static_cast<std::int64_t>(resting - orders.size());
+    if (orders.empty()) {
+      FlightRecorder::record(FlightEventType::LevelErased, order, 0, it->first);
+      book.erase(it);
     }
   }
-  if (order.quantity > 0 && order.type == OrderType::LIMIT) {
-    insertOrder(order);
+  MetricsRegistry::add(Counter::TradesOut, trades.size() - first_trade);
+  if constexpr (T == OrderType::LIMIT) {
+    if (order.quantity > 0) {
+      rest<S>(order);
+      return;
+    }
+  } else {
+    if (order.quantity > 0) {
+      MetricsRegistry::add(Counter::IocRemaindersDropped);
+    }
   }
-  return trades;
+  publish();
 }
 
+template class BasicOrderBook<FifoAllocation>;
+template class BasicOrderBook<ProRataAllocation>;
+template class BasicOrderBook<TopOrderProRataAllocation>;
+
 } // namespace fm
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 
+#include "flashmatch/metrics.hpp"
 #include "flashmatch/order_queue.hpp"
 #include "order_gateway.grpc.pb.h"
 #include "types/ordertype.hpp"
@@ -22,6 +23,7 @@ class OrderGatewayService final : public flashmatch::OrderGateway::Service {
                 request->type() == flashmatch::LIMIT ? OrderType::LIMIT : OrderType::IOC};
 
     bool pushed = g_order_queue.push(order);
+    fm::MetricsRegistry::add(pushed ? fm::Counter::QueuePushes : fm::Counter::QueuePushFailures);
     response->set_ok(pushed);
     return grpc::Status::OK;
   }
@@ -29,6 +31,18 @@ class OrderGatewayService final : public flashmatch::OrderGateway::Service {
 
 int main() {
   const std::string server_address{"0.0.0.0:50051"};
+  // Prometheus scrape endpoint on localhost, snapshotted once a second.
+  constexpr int kMetricsPort = 9464;
+
+  fm::MetricsRegistry::instance().add_gauge("queue_depth", [] {
+    return static_cast<std::int64_t>(g_order_queue.depth());
+  });
+  fm::MetricsExporter metrics({.http_port = kMetricsPort});
+  if (metrics.ok()) {
+    std::cout << "Metrics on http://127.0.0.1:" << metrics.port() << "/metrics" << std::endl;
+  } else {
+    std::cout << "Metrics disabled: " << metrics.error() << std::endl;
+  }
   OrderGatewayService service;
 
   grpc::ServerBuilder builder;
@@ -0,0 +1,109 @@
+#include "flashmatch/order_generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+#include "flashmatch/symbol_map.hpp"
+
+namespace fm {
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t &x) {
+  std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+} // namespace
+
+OrderGenerator::OrderGenerator(const GeneratorConfig &config) : config_(config) {
+  config_.symbol_count = std::max<std::size_t>(config_.symbol_count, 1);
+  config_.max_quantity = std::max(config_.max_quantity, config_.min_quantity);
+  header_.total_rows = config_.total_orders;
+  header_.warmup_rows = std::min(config_.warmup_orders, config_.total_orders);
+
+  symbols_.reserve(config_.symbol_count);
+  for (std::size_t i = 0; i < config_.symbol_count; ++i) {
+    symbols_.push_back("SYM" + std::to_string(i));
+    symbol_hashes_.push_back(symbol_hash(symbols_.back()));
+  }
+  reset();
+}
+
+void OrderGenerator::reset() {
+  std::uint64_t seed = config_.seed;
+  for (auto &word : state_) {
+    word = splitmix64(seed);
+  }
+  auto mid = static_cast<std::int64_t>(std::llround(config_.initial_mid / config_.tick_size));
+  mid_ticks_.assign(config_.symbol_count, mid);
+  emitted_ = 0;
+}
+
+std::uint64_t OrderGenerator::next_u64() {
+  const std::uint64_t result = rotl(state_[1] * 5, 7) * 9;
+  const std::uint64_t t = state_[1] << 17;
+  state_[2] ^= state_[0];
+  state_[3] ^= state_[1];
+  state_[1] ^= state_[2];
+  state_[0] ^= state_[3];
+  state_[2] ^= t;
+  state_[3] = rotl(state_[3], 45);
+  return result;
+}
+
+std::uint64_t OrderGenerator::next_below(std::uint64_t bound) {
+  // Lemire's multiply-shift; the bias is negligible for these small bounds.
+  return static_cast<std::uint64_t>((static_cast<unsigned __int128>(next_u64()) * bound) >> 64);
+}
+
+double OrderGenerator::next_unit() {
+  return static_cast<double>(next_u64() >> 11) * 0x1.0p-53;
+}
+
+void OrderGenerator::next(Order &out) {
+  const bool warmup = emitted_ < header_.warmup_rows;
+  const std::size_t symbol = next_below(symbols_.size());
+
+  std::int64_t &mid = mid_ticks_[symbol];
+  if (next_unit() < config_.mid_move_probability) {
+    mid += (next_u64() & 1) ? 1 : -1;
+    mid = std::max<std::int64_t>(mid, config_.price_range_ticks + 1);
+  }
+  const std::uint64_t range = 2 * std::uint64_t{config_.price_range_ticks} + 1;
+  const std::int64_t offset =
+      static_cast<std::int64_t>(next_below(range)) - config_.price_range_ticks;
+
+  out.id = ++emitted_;
+  out.symbol.assign(symbols_[symbol]);
+  out.symbol_hash = symbol_hashes_[symbol];
+  out.side = (next_u64() & 1) ? Side::BUY : Side::SELL;
+  out.price = static_cast<double>(mid + offset) * config_.tick_size;
+  out.quantity =
+      config_.min_quantity + next_below(config_.max_quantity - config_.min_quantity + 1);
+  out.type = (!warmup && next_unit() < config_.ioc_ratio) ? OrderType::IOC : OrderType::LIMIT;
+}
+
+bool OrderGenerator::for_each_batch(const OrderBatchSink &sink) {
+  reset();
+  std::vector<Order> batch(std::min<std::size_t>(kBatchSize, header_.total_rows));
+  std::size_t remaining = header_.total_rows;
+  while (remaining > 0) {
+    std::size_t count = std::min(batch.size(), remaining);
+    for (std::size_t i = 0; i < count; ++i) {
+      next(batch[i]);
+    }
+    remaining -= count;
+    if (!sink(std::span<const Order>(batch.data(), count))) {
+      break;
+    }
+  }
+  return true;
+}
+
+} // namespace fm
@@ -0,0 +1,359 @@
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flashmatch/bench_results.hpp"
+#include "flashmatch/benchmark.hpp"
+#include "flashmatch/flight_recorder.hpp"
+#include "flashmatch/order_generator.hpp"
+#include "flashmatch/scaling_bench.hpp"
+
+namespace {
+
+struct Options {
+  std::string dataset;
+  std::optional<std::size_t> warmup;
+  std::size_t generated_orders = fm::GeneratorConfig{}.total_orders;
+  std::uint64_t seed = fm::GeneratorConfig{}.seed;
+  std::size_t symbols = fm::GeneratorConfig{}.symbol_count;
+  std::size_t threads = 0;
+  std::size_t load_threads = 1;
+  std::vector<int> cpus;
+  std::string mode = "submit";
+  fm::Allocation allocation = fm::Allocation::Fifo;
+  int repeat = 1;
+  int cpu = -1;
+  std::string json_path;
+  std::string csv_path;
+  std::string baseline_path;
+  std::string journal_path;
+  bool fail_on_regression = false;
+  std::size_t dump_over_us = 0;
+  std::string dump_prefix = "flashmatch_spike";
+  bool perf = false;
+};
+
+void print_usage(const char *argv0) {
+  std::cout << "Usage: " << argv0 << " [options] [dataset]\n"
+            << "  dataset             CSV, JSON lines, gzip or .bin dataset. Without one,\n"
+            << "                      order flow is generated in-process.\n"
+            << "  --warmup N          Override the dataset's warmup row count\n"
+            << "  --orders N          Generated orders, including warmup (default "
+            << fm::GeneratorConfig{}.total_orders << ")\n"
+            << "  --seed N            Generator seed\n"
+            << "  --symbols N         Generated symbol count\n"
+            << "  --mode MODE         submit: per-order submit() latency (default)\n"
+            << "                      batch: add() every order, time one run()\n"
+            << "                      grouped: as batch, timing run_grouped()\n"
+            << "                      submit_batch: one submit_batch() over every order\n"
+            << "                      scaling: 1..N engines on pinned cores, flow split by\n"
+            << "                      symbol; loads the whole flow into memory\n"
+            << "  --allocation NAME   Level allocation for every book: fifo (default),\n"
+            << "                      pro_rata or top_order_pro_rata\n"
+            << "  --load-threads N    Threads building books from the warmup orders\n"
+            << "                      (default 1, 0 = one per CPU)\n"
+            << "  --journal PATH      Journal each measured order to PATH before submit()\n"
+            << "                      (submit mode; PATH is overwritten)\n"
+            << "  --threads N         Largest engine count for scaling (default: all CPUs;\n"
+            << "                      at most the symbol count)\n"
+            << "  --cpus A,B,...      CPUs to pin scaling threads to, in order\n"
+            << "  --repeat N          Run the benchmark N times\n"
+            << "  --cpu N             Pin the benchmark thread to CPU N\n"
+            << "  --json PATH         Append one JSON line per run to PATH\n"
+            << "  --csv PATH          Append one CSV row per run to PATH (scaling mode:\n"
+            << "                      one row per thread count and thread)\n"
+            << "  --baseline PATH     Compare this invocation's runs against a --json file\n"
+            << "  --fail-on-regression  Exit with status 2 if --baseline flags a regression\n"
+            << "  --perf              Report hardware counters per order for each phase\n"
+            << "  --dump-over-us N    Dump the flight recorder to PREFIX.0.fr the first time\n"
+            << "                      one submit() takes over N us\n"
+            << "  --dump-prefix P     Spike dump prefix (default flashmatch_spike)\n"
+            << "SIGUSR2 dumps the flight recorder to flashmatch_flight.fr at any time.\n";
+}
+
+bool parse_size(const char *text, std::size_t &out) {
+  char *end = nullptr;
+  unsigned long long value = std::strtoull(text, &end, 10);
+  if (end == text || *end != '\0') {
+    return false;
+  }
+  out = static_cast<std::size_t>(value);
+  return true;
+}
+
+bool parse_options(int argc, char *argv[], Options &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto value = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+    std::size_t number = 0;
+    if (arg == "--warmup" || arg == "--orders" || arg == "--seed" || arg == "--repeat" ||
+        arg == "--cpu" || arg == "--symbols" || arg == "--threads" || arg == "--dump-over-us" ||
+        arg == "--load-threads") {
+      const char *text = value();
+      if (text == nullptr || !parse_size(text, number)) {
+        std::cout << "Expected a number after " << arg << std::endl;
+        return false;
+      }
+      if (arg == "--warmup") {
+        options.warmup = number;
+      } else if (arg == "--orders") {
+        options.generated_orders = number;
+      } else if (arg == "--seed") {
+        options.seed = number;
+      } else if (arg == "--symbols") {
+        options.symbols = number;
+      } else if (arg == "--threads") {
+        options.threads = number;
+      } else if (arg == "--load-threads") {
+        options.load_threads = number;
+      } else if (arg == "--dump-over-us") {
+        options.dump_over_us = number;
+      } else if (arg == "--repeat") {
+        options.repeat = static_cast<int>(number);
+      } else {
+        options.cpu = static_cast<int>(number);
+      }
+    } else if (arg == "--mode" || arg == "--json" || arg == "--csv" || arg == "--baseline" ||
+               arg == "--dump-prefix" || arg == "--journal") {
+      const char *text = value();
+      if (text == nullptr) {
+        std::cout << "Expected a value after " << arg << std::endl;
+        return false;
+      }
+      (arg == "--mode"       ? options.mode
+       : arg == "--json"     ? options.json_path
+       : arg == "--csv"      ? options.csv_path
+       : arg == "--baseline" ? options.baseline_path
+       : arg == "--journal"  ? options.journal_path
+                             : options.dump_prefix) = text;
+    } else if (arg == "--allocation") {
+      const char *text = value();
+      if (text == nullptr || !fm::parse_allocation(text, options.allocation)) {
+        std::cout << "Unknown allocation: " << (text != nullptr ? text : "") << std::endl;
+        return false;
+      }
+    } else if (arg == "--cpus") {
+      const char *text = value();
+      std::string_view list = text != nullptr ? text : "";
+      while (!list.empty()) {
+        auto comma = list.find(',');
+        std::string item(list.substr(0, comma));
+        if (!parse_size(item.c_str(), number)) {
+          std::cout << "Bad CPU list: " << (text != nullptr ? text : "") << std::endl;
+          return false;
+        }
+        options.cpus.push_back(static_cast<int>(number));
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+      }
+    } else if (arg == "--perf") {
+      options.perf = true;
+    } else if (arg == "--fail-on-regression") {
+      options.fail_on_regression = true;
+    } else if (arg == "-h" || arg == "--help") {
+      return false;
+    } else if (!arg.starts_with("--") && options.dataset.empty()) {
+      options.dataset = arg;
+    } else {
+      std::cout << "Unknown option: " << arg << std::endl;
+      return false;
+    }
+  }
+  if (options.mode != "submit" && options.mode != "batch" && options.mode != "grouped" &&
+      options.mode != "submit_batch" && options.mode != "scaling") {
+    std::cout << "Unknown mode: " << options.mode << std::endl;
+    return false;
+  }
+  if (!options.baseline_path.empty() && options.mode == "scaling") {
+    std::cout << "--baseline is not supported in scaling mode" << std::endl;
+    return false;
+  }
+  if (options.allocation != fm::Allocation::Fifo && options.mode == "scaling") {
+    std::cout << "--allocation is not supported in scaling mode" << std::endl;
+    return false;
+  }
+  if (!options.journal_path.empty() && options.mode != "submit") {
+    std::cout << "--journal is only supported in submit mode" << std::endl;
+    return false;
+  }
+  return options.repeat > 0;
+}
+
+std::string utc_timestamp() {
+  std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::tm tm{};
+  gmtime_r(&now, &tm);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buf;
+}
+
+// Baseline runs of the same mode, narrowed to the same source when the file
+// has any; a baseline taken on a different source is still worth a look.
+std::vector<fm::BenchRecord> matching_baseline(const std::string &path,
+                                               const fm::BenchRecord &current) {
+  std::vector<fm::BenchRecord> same_mode, same_source;
+  for (fm::BenchRecord &record : fm::read_records_json(path)) {
+    if (record.mode != current.mode) {
+      continue;
+    }
+    if (record.source == current.source) {
+      same_source.push_back(record);
+    }
+    same_mode.push_back(std::move(record));
+  }
+  return same_source.empty() ? same_mode : same_source;
+}
+
+int run_scaling(const Options &options, const fm::GeneratorConfig &config, std::ofstream &csv) {
+  fm::ScalingOptions scaling;
+  scaling.max_threads = options.threads;
+  scaling.cpus = options.cpus;
+  scaling.warmup_rows = options.warmup;
+  for (int run = 0; run < options.repeat; ++run) {
+    std::vector<fm::ScalingPoint> points = options.dataset.empty()
+                                               ? fm::run_scaling_bench(config, scaling)
+                                               : fm::run_scaling_bench(options.dataset, scaling);
+    if (points.empty()) {
+      return 1;
+    }
+    fm::output_scaling(points);
+    if (csv.is_open()) {
+      for (const fm::ScalingPoint &point : points) {
+        fm::write_scaling_csv(csv, point);
+      }
+      csv.flush();
+    }
+  }
+  std::cout << "Benchmark completed." << std::endl;
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parse_options(argc, argv, options)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+  if (options.cpu >= 0 && !fm::pin_thread_to_cpu(options.cpu)) {
+    std::cout << "Failed to pin to CPU " << options.cpu << std::endl;
+    return 1;
+  }
+
+  fm::GeneratorConfig config;
+  config.total_orders = options.generated_orders;
+  config.warmup_orders = options.warmup.value_or(options.generated_orders / 6);
+  config.seed = options.seed;
+  config.symbol_count = options.symbols;
+  fm::BenchOptions bench_options;
+  bench_options.warmup_rows = options.warmup;
+  bench_options.perf_counters = options.perf;
+  bench_options.batch_mode = options.mode == "grouped"        ? fm::BatchMode::Grouped
+                             : options.mode == "submit_batch" ? fm::BatchMode::SubmitBatch
+                                                              : fm::BatchMode::Run;
+  bench_options.allocation = options.allocation;
+  bench_options.load_threads = options.load_threads;
+  bench_options.journal_path = options.journal_path;
+  bench_options.spike_dump_ns = options.dump_over_us * 1000;
+  bench_options.spike_dump_prefix = options.dump_prefix;
+  fm::install_flight_recorder_signal("flashmatch_flight.fr");
+  const bool generated = options.dataset.empty();
+  const bool batch = options.mode != "submit";
+
+  fm::BenchRecord record;
+  record.source = generated ? "generated:" + std::to_string(config.total_orders) + ":seed" +
+                                  std::to_string(config.seed)
+                            : options.dataset;
+  // Runs under another allocation policy are not comparable with FIFO ones.
+  record.mode = options.mode;
+  if (options.allocation != fm::Allocation::Fifo) {
+    record.mode += std::string(":") + fm::allocation_name(options.allocation);
+  }
+  if (!options.journal_path.empty()) {
+    record.mode += ":journal";
+  }
+  record.environment = fm::bench_environment();
+
+  std::ofstream json, csv;
+  if (!options.json_path.empty()) {
+    json.open(options.json_path, std::ios::app);
+  }
+  if (!options.csv_path.empty()) {
+    bool fresh = !std::filesystem::exists(options.csv_path) ||
+                 std::filesystem::file_size(options.csv_path) == 0;
+    csv.open(options.csv_path, std::ios::app);
+    if (fresh) {
+      if (options.mode == "scaling") {
+        fm::write_scaling_csv_header(csv);
+      } else {
+        fm::write_record_csv_header(csv);
+      }
+    }
+  }
+
+  std::vector<fm::BenchRecord> baseline;
+  if (!options.baseline_path.empty()) {
+    baseline = matching_baseline(options.baseline_path, record);
+    if (baseline.empty()) {
+      std::cout << "No " << options.mode << " runs in baseline " << options.baseline_path
+                << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Initializing Benchmark !" << std::endl;
+  if (options.mode == "scaling") {
+    return run_scaling(options, config, csv);
+  }
+  std::vector<fm::BenchRecord> records;
+  for (int run = 0; run < options.repeat; ++run) {
+    fm::BenchStats stats;
+    if (generated) {
+      stats = batch ? fm::run_batch_bench(config, bench_options)
+                    : fm::run_bench(config, bench_options);
+    } else {
+      stats = batch ? fm::run_batch_bench(options.dataset, bench_options)
+                    : fm::run_bench(options.dataset, bench_options);
+    }
+    if (stats.num_orders == 0) {
+      std::cout << "Benchmark processed no orders" << std::endl;
+      return 1;
+    }
+
+    if (options.repeat > 1) {
+      std::cout << "--- Run " << run + 1 << " of " << options.repeat << " ---" << std::endl;
+    }
+    fm::output_stats(stats);
+
+    record.timestamp = utc_timestamp();
+    record.run = run;
+    record.stats = stats;
+    if (json.is_open()) {
+      fm::write_record_json(json, record);
+      json.flush();
+    }
+    if (csv.is_open()) {
+      fm::write_record_csv(csv, record);
+      csv.flush();
+    }
+    records.push_back(record);
+  }
+  std::cout << "Benchmark completed." << std::endl;
+
+  if (!baseline.empty()) {
+    std::vector<fm::MetricDelta> deltas = fm::compare_records(baseline, records);
+    fm::output_comparison(deltas, baseline.size(), records.size());
+    if (options.fail_on_regression && fm::has_regression(deltas)) {
+      return 2;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,183 @@
+#include "flashmatch/perf_counters.hpp"
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+namespace fm {
+
+namespace {
+
+perf_event_attr attr_for(PerfEvent event) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  auto cache = [](std::uint64_t cache_id) {
+    return cache_id | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  };
+  switch (event) {
+    case PerfEvent::Cycles:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PerfEvent::Instructions:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PerfEvent::BranchMisses:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+    case PerfEvent::L1dMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cache(PERF_COUNT_HW_CACHE_L1D);
+      break;
+    case PerfEvent::LlcMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cache(PERF_COUNT_HW_CACHE_LL);
+      break;
+    case PerfEvent::DtlbMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cache(PERF_COUNT_HW_CACHE_DTLB);
+      break;
+  }
+  return attr;
+}
+
+int open_event(PerfEvent event, int group_fd) {
+  perf_event_attr attr = attr_for(event);
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+std::string paranoid_level() {
+  std::ifstream in("/proc/sys/kernel/perf_event_paranoid");
+  std::string level;
+  in >> level;
+  return level.empty() ? "unknown" : level;
+}
+
+} // namespace
+
+const char *perf_event_name(PerfEvent event) {
+  switch (event) {
+    case PerfEvent::Cycles:
+      return "cycles";
+    case PerfEvent::Instructions:
+      return "instructions";
+    case PerfEvent::L1dMisses:
+      return "l1d-misses";
+    case PerfEvent::LlcMisses:
+      return "llc-misses";
+    case PerfEvent::BranchMisses:
+      return "branch-misses";
+    case PerfEvent::DtlbMisses:
+      return "dtlb-misses";
+  }
+  return "unknown";
+}
+
+bool PerfCounts::any() const {
+  for (bool p : present) {
+    if (p) {
+      return true;
+    }
+  }
+  return false;
+}
+
+PerfCounters::PerfCounters() {
+  const std::vector<std::vector<PerfEvent>> layout = {
+      {PerfEvent::Cycles, PerfEvent::Instructions, PerfEvent::BranchMisses},
+      {PerfEvent::L1dMisses, PerfEvent::LlcMisses, PerfEvent::DtlbMisses},
+  };
+  std::string missing;
+  int first_errno = 0;
+  for (const auto &events : layout) {
+    Group group;
+    for (PerfEvent event : events) {
+      int fd = open_event(event, group.leader);
+      if (fd < 0) {
+        first_errno = first_errno != 0 ? first_errno : errno;
+        missing += missing.empty() ? "" : ", ";
+        missing += perf_event_name(event);
+        continue;
+      }
+      if (group.leader < 0) {
+        group.leader = fd;
+      }
+      group.fds.push_back(fd);
+      group.events.push_back(event);
+    }
+    if (group.leader >= 0) {
+      groups_.push_back(std::move(group));
+    }
+  }
+  if (!missing.empty()) {
+    error_ = "unavailable: " + missing + " (" + std::strerror(first_errno) +
+             ", perf_event_paranoid=" + paranoid_level() + ")";
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const Group &group : groups_) {
+    for (int fd : group.fds) {
+      ::close(fd);
+    }
+  }
+}
+
+void PerfCounters::reset() {
+  for (const Group &group : groups_) {
+    ioctl(group.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void PerfCounters::enable() {
+  for (const Group &group : groups_) {
+    ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void PerfCounters::disable() {
+  for (const Group &group : groups_) {
+    ioctl(group.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+PerfCounts PerfCounters::read() const {
+  PerfCounts counts;
+  for (const Group &group : groups_) {
+    // { nr, time_enabled, time_running, value[nr] }
+    std::uint64_t buf[3 + kPerfEventCount] = {};
+    ssize_t n = ::read(group.leader, buf, sizeof(buf));
+    if (n < static_cast<ssize_t>(3 * sizeof(std::uint64_t)) || buf[0] != group.events.size()) {
+      continue;
+    }
+    const std::uint64_t enabled = buf[1];
+    const std::uint64_t running = buf[2];
+    for (std::size_t i = 0; i < group.events.size(); ++i) {
+      std::uint64_t value = buf[3 + i];
+      if (running > 0 && running < enabled) {
+        value = static_cast<std::uint64_t>(static_cast<double>(value) *
+                                           static_cast<double>(enabled) /
+                                           static_cast<double>(running));
+      }
+      auto index = static_cast<std::size_t>(group.events[i]);
+      counts.present[index] = true;
+      counts.values[index] = value;
+    }
+  }
+  return counts;
+}
+
+} // namespace fm
@@ -0,0 +1,132 @@
+#include "flashmatch/recovery.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "flashmatch/journal.hpp"
+#include "flashmatch/mapped_file.hpp"
+#include "flashmatch/matching_engine.hpp"
+#include "flashmatch/snapshot.hpp"
+
+namespace fm {
+
+namespace {
+
+// Orders handed to submit_batch() at a time.
+constexpr std::size_t kReplayBatch = 4096;
+
+// Counts replayed trades without keeping them.
+class CountingSink : public TradeSink {
+public:
+  void on_trades(const Order &, std::span<const Trade> trades) override {
+    count += trades.size();
+  }
+  std::uint64_t count = 0;
+};
+
+double elapsed_us(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+std::string latest_snapshot(const std::string &directory) {
+  std::string latest;
+  std::uint64_t latest_sequence = 0;
+  std::error_code error;
+  for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+    if (!entry.is_regular_file() || entry.path().extension() != ".snap") {
+      continue;
+    }
+    SnapshotHeader header{};
+    std::ifstream in(entry.path(), std::ios::binary);
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header.version != kSnapshotVersion) {
+      continue;
+    }
+    if (latest.empty() || header.sequence > latest_sequence) {
+      latest = entry.path().string();
+      latest_sequence = header.sequence;
+    }
+  }
+  return latest;
+}
+
+bool recover(MatchingEngine &engine, const std::string &snapshot_path,
+             const std::string &journal_path, RecoveryStats &stats, std::size_t threads) {
+  stats = RecoveryStats{};
+  // Check the whole journal before touching the engine, so damage found
+  // late does not leave it half replayed.
+  MappedFile file;
+  JournalReader reader;
+  double check_time_us = 0.0;
+  if (!journal_path.empty()) {
+    file = MappedFile(journal_path);
+    if (!file.is_open() || !reader.open(file.view())) {
+      std::cout << "Failed to open journal: " << journal_path << std::endl;
+      return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    JournalReader check = reader;
+    check.verify();
+    if (!check.at_end()) {
+      if (!check.torn_tail()) {
+        // Intact records follow; they were synced and may have been acked.
+        std::cout << "Journal " << journal_path << " is damaged at byte " << check.offset()
+                  << std::endl;
+        return false;
+      }
+      stats.torn_tail = true;
+    }
+    check_time_us = elapsed_us(start);
+  }
+
+  if (!snapshot_path.empty()) {
+    auto start = std::chrono::steady_clock::now();
+    if (!engine.load_snapshot(snapshot_path, threads)) {
+      return false;
+    }
+    stats.snapshot_time_us = elapsed_us(start);
+  }
+  stats.snapshot_sequence = engine.sequence();
+  if (journal_path.empty()) {
+    return true;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  stats.skipped = reader.skip_through(engine.sequence());
+
+  std::vector<Order> batch(kReplayBatch);
+  CountingSink sink;
+  std::uint64_t sequence = 0;
+  bool first = true;
+  while (true) {
+    std::size_t n = 0;
+    while (n < batch.size() && reader.next(sequence, batch[n])) {
+      if (first && sequence != engine.sequence() + 1) {
+        std::cout << "Journal " << journal_path << " resumes at sequence " << sequence
+                  << ", expected " << engine.sequence() + 1 << std::endl;
+        return false;
+      }
+      first = false;
+      ++n;
+    }
+    if (n == 0) {
+      break;
+    }
+    engine.submit_batch(std::span<const Order>(batch.data(), n), sink);
+    stats.replayed += n;
+  }
+  stats.replay_time_us = check_time_us + elapsed_us(start);
+  stats.trades = sink.count;
+  return true;
+}
+
+} // namespace fm
@@ -0,0 +1,234 @@
+#include "flashmatch/scaling_bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include "flashmatch/dataset_reader.hpp"
+#include "flashmatch/latency_histogram.hpp"
+#include "flashmatch/matching_engine.hpp"
+#include "flashmatch/order_generator.hpp"
+#include "flashmatch/tsc_clock.hpp"
+
+namespace fm {
+
+namespace {
+
+// The whole flow in memory, with each order's symbol numbered in order of
+// first appearance.
+struct LoadedFlow {
+  std::vector<Order> orders;
+  std::vector<std::uint32_t> symbol_index;
+  std::size_t symbol_count = 0;
+  std::size_t warmup_rows = 0;
+};
+
+template <typename Source>
+bool load_flow(Source &source, std::optional<std::size_t> warmup_rows, LoadedFlow &flow) {
+  const DatasetHeader &header = source.header();
+  flow.orders.reserve(header.total_rows);
+  flow.symbol_index.reserve(header.total_rows);
+  std::unordered_map<std::string, std::uint32_t> symbols;
+  bool ok = source.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      auto [it, inserted] = symbols.try_emplace(order.symbol, symbols.size());
+      flow.orders.push_back(order);
+      flow.symbol_index.push_back(it->second);
+    }
+    return flow.orders.size() < header.total_rows;
+  });
+  if (flow.orders.size() > header.total_rows) {
+    flow.orders.resize(header.total_rows);
+    flow.symbol_index.resize(header.total_rows);
+  }
+  flow.symbol_count = symbols.size();
+  flow.warmup_rows = std::min(warmup_rows.value_or(header.warmup_rows), flow.orders.size());
+  if constexpr (requires { source.error_line(); }) {
+    if (!ok) {
+      std::cout << "Failed to parse line: " << source.error_line() << std::endl;
+    }
+  }
+  return ok;
+}
+
+struct ThreadResult {
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point finish;
+  BenchStats stats;
+};
+
+ScalingPoint run_point(const LoadedFlow &flow, std::size_t threads, const ScalingOptions &options) {
+  std::vector<ThreadResult> results(threads);
+  std::atomic<std::size_t> ready{0};
+  std::atomic<bool> go{false};
+  const TscClock &clock = TscClock::instance();
+
+  auto worker = [&](std::size_t t) {
+    int cpu = options.cpus.empty() ? static_cast<int>(t)
+                                   : options.cpus[t % options.cpus.size()];
+    // Best effort: with more threads than CPUs the OS schedules the rest.
+    pin_thread_to_cpu(cpu);
+
+    // Copy this thread's shard from its own CPU so the pages are local.
+    std::vector<Order> warmup, measured;
+    for (std::size_t i = 0; i < flow.orders.size(); ++i) {
+      if (flow.symbol_index[i] % threads == t) {
+        (i < flow.warmup_rows ? warmup : measured).push_back(flow.orders[i]);
+      }
+    }
+    MatchingEngine engine;
+    engine.bulk_insert(warmup);
+
+    ready.fetch_add(1, std::memory_order_acq_rel);
+    while (!go.load(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+
+    ThreadResult &result = results[t];
+    LatencyHistogram latencies;
+    result.start = std::chrono::steady_clock::now();
+    for (const Order &order : measured) {
+      std::uint64_t start = clock.start();
+      engine.submit(order);
+      latencies.record(clock.to_ns(clock.stop() - start));
+    }
+    result.finish = std::chrono::steady_clock::now();
+
+    result.stats.total_orders = warmup.size() + measured.size();
+    result.stats.warmup_orders = warmup.size();
+    result.stats.total_time_us =
+        std::chrono::duration<double, std::micro>(result.finish - result.start).count();
+    result.stats.timer = clock.describe();
+    fill_latency_stats(latencies, result.stats);
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads);
+  for (std::size_t t = 0; t < threads; ++t) {
+    pool.emplace_back(worker, t);
+  }
+  while (ready.load(std::memory_order_acquire) < threads) {
+    std::this_thread::yield();
+  }
+  go.store(true, std::memory_order_release);
+  for (auto &thread : pool) {
+    thread.join();
+  }
+
+  ScalingPoint point;
+  point.threads = threads;
+  auto first = results.front().start;
+  auto last = results.front().finish;
+  for (const ThreadResult &result : results) {
+    first = std::min(first, result.start);
+    last = std::max(last, result.finish);
+    point.measured_orders += result.stats.num_orders;
+    point.per_thread.push_back(result.stats);
+  }
+  point.wall_time_us = std::chrono::duration<double, std::micro>(last - first).count();
+  point.orders_per_sec =
+      point.wall_time_us > 0.0 ? static_cast<double>(point.measured_orders) * 1e6 / point.wall_time_us
+                               : 0.0;
+  return point;
+}
+
+std::vector<ScalingPoint> run_points(const LoadedFlow &flow, const ScalingOptions &options) {
+  std::size_t max_threads = options.max_threads != 0
+                                ? options.max_threads
+                                : std::max(1u, std::thread::hardware_concurrency());
+  // Threads own whole symbols, so any beyond the symbol count would sit idle.
+  if (max_threads > flow.symbol_count) {
+    std::cout << "Only " << flow.symbol_count << " symbols in the flow: scaling up to "
+              << flow.symbol_count << " threads instead of " << max_threads << std::endl;
+    max_threads = flow.symbol_count;
+  }
+  std::vector<ScalingPoint> points;
+  for (std::size_t n = 1; n <= max_threads; ++n) {
+    points.push_back(run_point(flow, n, options));
+  }
+  return points;
+}
+
+template <typename Fn> double worst(const ScalingPoint &point, Fn &&field) {
+  double value = 0.0;
+  for (const BenchStats &stats : point.per_thread) {
+    value = std::max(value, field(stats));
+  }
+  return value;
+}
+
+} // namespace
+
+std::vector<ScalingPoint> run_scaling_bench(const std::string &filename,
+                                            const ScalingOptions &options) {
+  DatasetReader reader(filename);
+  if (!reader.is_open()) {
+    std::cout << "Failed to open dataset: " << filename << std::endl;
+    return {};
+  }
+  LoadedFlow flow;
+  if (!load_flow(reader, options.warmup_rows, flow)) {
+    return {};
+  }
+  return run_points(flow, options);
+}
+
+std::vector<ScalingPoint> run_scaling_bench(const GeneratorConfig &config,
+                                            const ScalingOptions &options) {
+  OrderGenerator generator(config);
+  LoadedFlow flow;
+  load_flow(generator, options.warmup_rows, flow);
+  return run_points(flow, options);
+}
+
+void output_scaling(const std::vector<ScalingPoint> &points) {
+  std::cout << "=== Flashmatch Scaling Benchmark ===\n";
+  if (points.empty()) {
+    std::cout << "No results" << std::endl;
+    return;
+  }
+  const double base = points.front().orders_per_sec;
+  std::cout << std::fixed;
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "M orders/s" << std::setw(10)
+            << "speedup" << std::setw(12) << "efficiency" << std::setw(12) << "p50 us"
+            << std::setw(12) << "p99 us" << std::setw(12) << "p99.9 us" << std::setw(12)
+            << "max us" << "\n";
+  for (const ScalingPoint &point : points) {
+    double speedup = base > 0.0 ? point.orders_per_sec / base : 0.0;
+    std::cout << std::setw(8) << point.threads << std::setprecision(2) << std::setw(14)
+              << point.orders_per_sec / 1e6 << std::setw(10) << speedup << std::setw(11)
+              << speedup / static_cast<double>(point.threads) * 100.0 << "%"
+              << std::setprecision(3) << std::setw(12)
+              << worst(point, [](const BenchStats &s) { return s.p50_latency; })
+              << std::setw(12) << worst(point, [](const BenchStats &s) { return s.p99_latency; })
+              << std::setw(12) << worst(point, [](const BenchStats &s) { return s.p999_latency; })
+              << std::setw(12)
+              << worst(point, [](const BenchStats &s) { return s.worst_latency_us; }) << "\n";
+  }
+  std::cout << "Latency columns are the worst thread at each thread count." << std::endl;
+}
+
+void write_scaling_csv_header(std::ostream &out) {
+  out << "threads,thread,orders,wall_time_us,aggregate_orders_per_sec,thread_time_us,mean_us,"
+         "p50_us,p99_us,p999_us,p9999_us,max_us\n";
+}
+
+void write_scaling_csv(std::ostream &out, const ScalingPoint &point) {
+  out << std::setprecision(6) << std::defaultfloat;
+  for (std::size_t t = 0; t < point.per_thread.size(); ++t) {
+    const BenchStats &s = point.per_thread[t];
+    out << point.threads << ',' << t << ',' << s.num_orders << ',' << point.wall_time_us << ','
+        << point.orders_per_sec << ',' << s.total_time_us << ',' << s.mean_latency << ','
+        << s.p50_latency << ',' << s.p99_latency << ',' << s.p999_latency << ','
+        << s.p9999_latency << ',' << s.worst_latency_us << '\n';
+  }
+}
+
+} // namespace fm
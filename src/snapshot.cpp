@@ -0,0 +1,328 @@
+#include "flashmatch/snapshot.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <unordered_set>
+
+#include "flashmatch/mapped_file.hpp"
+#include "flashmatch/matching_engine.hpp"
+
+namespace fm {
+
+namespace {
+
+constexpr std::size_t kWriteBuffer = 1 << 20;
+
+std::size_t padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+
+// Buffered writes to a file descriptor, keeping a running CRC-32 of
+// everything written.
+class ChecksumWriter {
+public:
+  explicit ChecksumWriter(int fd) : fd_(fd) { buffer_.reserve(kWriteBuffer); }
+
+  void write(const void *data, std::size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    crc_ = crc32_z(crc_, reinterpret_cast<const Bytef *>(bytes), size);
+    if (buffer_.size() + size > kWriteBuffer) {
+      flush();
+    }
+    if (size > kWriteBuffer) {
+      write_fully(bytes, size);
+    } else {
+      buffer_.insert(buffer_.end(), bytes, bytes + size);
+    }
+  }
+  template <typename T> void write(const T &record) { write(&record, sizeof(record)); }
+
+  bool flush() {
+    write_fully(buffer_.data(), buffer_.size());
+    buffer_.clear();
+    return ok_;
+  }
+  std::uint32_t crc() const { return static_cast<std::uint32_t>(crc_); }
+
+private:
+  void write_fully(const char *data, std::size_t size) {
+    while (ok_ && size > 0) {
+      ssize_t written = ::write(fd_, data, size);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        ok_ = false;
+        return;
+      }
+      data += written;
+      size -= static_cast<std::size_t>(written);
+    }
+  }
+
+  int fd_;
+  std::vector<char> buffer_;
+  uLong crc_ = crc32_z(0, nullptr, 0);
+  bool ok_ = true;
+};
+
+// AnyOrderBook alternatives are listed in Allocation order.
+Allocation book_allocation(const AnyOrderBook &book) {
+  return static_cast<Allocation>(book.index());
+}
+
+} // namespace
+
+bool MatchingEngine::save_snapshot(const std::string &path) const {
+  SnapshotHeader header{};
+  std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+  header.version = kSnapshotVersion;
+  header.book_count = static_cast<std::uint32_t>(books_.size());
+  header.sequence = sequence_;
+
+  std::string table;
+  std::vector<SnapshotBook> books;
+  std::vector<SnapshotLevel> levels;
+  std::vector<const PriceLevel *> level_orders;
+  books.reserve(books_.size());
+  for (const auto &entry : books_) {
+    if (entry.key.size() > std::numeric_limits<std::uint16_t>::max()) {
+      std::cout << "Symbol too long for snapshot: " << entry.key << std::endl;
+      return false;
+    }
+    auto length = static_cast<std::uint16_t>(entry.key.size());
+    table.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    table.append(entry.key);
+
+    SnapshotBook book{};
+    book.allocation = static_cast<std::uint8_t>(book_allocation(entry.value));
+    std::visit(
+        [&](const auto &symbol_book) {
+          symbol_book.for_each_level([&](Side side, double price, const PriceLevel &level) {
+            levels.push_back({price, static_cast<std::uint32_t>(level.orders.size()),
+                              static_cast<std::uint8_t>(side),
+                              static_cast<std::uint8_t>(level.top_order_live), 0});
+            level_orders.push_back(&level);
+            header.order_count += level.orders.size();
+          });
+        },
+        entry.value);
+    book.level_count = levels.size() - header.level_count;
+    header.level_count = levels.size();
+    books.push_back(book);
+  }
+  table.resize(padded(table.size()), '\0');
+  header.symbol_table_bytes = table.size();
+
+  // Written beside the target and renamed over it, so a crash never leaves
+  // a half-written snapshot at path.
+  const std::string tmp_path = path + ".tmp";
+  int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    std::cout << "Failed to open snapshot: " << tmp_path << std::endl;
+    return false;
+  }
+  if (::lseek(fd, sizeof(header), SEEK_SET) < 0) {
+    ::close(fd);
+    return false;
+  }
+  ChecksumWriter out(fd);
+  out.write(table.data(), table.size());
+  out.write(books.data(), books.size() * sizeof(SnapshotBook));
+  out.write(levels.data(), levels.size() * sizeof(SnapshotLevel));
+  for (const PriceLevel *level : level_orders) {
+    for (const Order &order : level->orders) {
+      out.write(SnapshotOrder{order.id, order.quantity, static_cast<std::uint8_t>(order.type), {}});
+    }
+  }
+  bool ok = out.flush();
+  header.crc32 = out.crc();
+  ok = ok && ::pwrite(fd, &header, sizeof(header), 0) == sizeof(header);
+  ok = ok && ::fdatasync(fd) == 0;
+  ok = ::close(fd) == 0 && ok;
+  ok = ok && std::rename(tmp_path.c_str(), path.c_str()) == 0;
+  if (!ok) {
+    std::cout << "Failed to write snapshot: " << path << std::endl;
+    std::remove(tmp_path.c_str());
+  }
+  return ok;
+}
+
+bool MatchingEngine::load_snapshot(const std::string &path, std::size_t threads) {
+  if (!books_.empty() || !pending_.empty()) {
+    std::cout << "Snapshots can only be loaded into an empty engine" << std::endl;
+    return false;
+  }
+  MappedFile file(path);
+  if (!file.is_open()) {
+    std::cout << "Failed to open snapshot: " << path << std::endl;
+    return false;
+  }
+  auto invalid = [&](const char *reason) {
+    std::cout << "Invalid snapshot " << path << ": " << reason << std::endl;
+    return false;
+  };
+
+  std::string_view data = file.view();
+  SnapshotHeader header;
+  if (data.size() < sizeof(header) ||
+      std::memcmp(data.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+    return invalid("not a snapshot");
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.version != kSnapshotVersion) {
+    return invalid("unsupported version");
+  }
+  // Each count is bounded by the file size before it is multiplied, so the
+  // size check below cannot overflow.
+  const std::size_t body = data.size() - sizeof(header);
+  if (header.symbol_table_bytes > body || header.book_count > body / sizeof(SnapshotBook) ||
+      header.level_count > body / sizeof(SnapshotLevel) ||
+      header.order_count > body / sizeof(SnapshotOrder) ||
+      header.symbol_table_bytes + header.book_count * sizeof(SnapshotBook) +
+              header.level_count * sizeof(SnapshotLevel) +
+              header.order_count * sizeof(SnapshotOrder) !=
+          body) {
+    return invalid("wrong size");
+  }
+  const auto *body_bytes = reinterpret_cast<const Bytef *>(data.data() + sizeof(header));
+  if (crc32_z(crc32_z(0, nullptr, 0), body_bytes, body) != header.crc32) {
+    return invalid("checksum mismatch");
+  }
+
+  const char *cursor = data.data() + sizeof(header) + header.symbol_table_bytes;
+  std::span<const SnapshotBook> books(reinterpret_cast<const SnapshotBook *>(cursor),
+                                      header.book_count);
+  cursor += books.size_bytes();
+  std::span<const SnapshotLevel> levels(reinterpret_cast<const SnapshotLevel *>(cursor),
+                                        header.level_count);
+  cursor += levels.size_bytes();
+  std::span<const SnapshotOrder> orders(reinterpret_cast<const SnapshotOrder *>(cursor),
+                                        header.order_count);
+
+  // Validate everything before creating a book, so a bad file leaves the
+  // engine empty. Records each book's first level and first order.
+  std::vector<std::string_view> symbols;
+  symbols.reserve(header.book_count);
+  // Two entries for one symbol would share a book and have two threads
+  // filling it.
+  std::unordered_set<std::string_view> seen;
+  seen.reserve(header.book_count);
+  std::string_view table = data.substr(sizeof(header), header.symbol_table_bytes);
+  for (std::uint32_t b = 0; b < header.book_count; ++b) {
+    std::uint16_t length = 0;
+    if (table.size() < sizeof(length)) {
+      return invalid("truncated symbol table");
+    }
+    std::memcpy(&length, table.data(), sizeof(length));
+    table.remove_prefix(sizeof(length));
+    if (table.size() < length) {
+      return invalid("truncated symbol table");
+    }
+    symbols.push_back(table.substr(0, length));
+    if (!seen.insert(symbols.back()).second) {
+      return invalid("duplicate symbol");
+    }
+    table.remove_prefix(length);
+  }
+  std::vector<std::size_t> first_level(books.size() + 1, 0);
+  std::vector<std::size_t> first_order(books.size() + 1, 0);
+  std::vector<std::size_t> sizes(books.size());
+  std::size_t level = 0;
+  std::size_t order = 0;
+  for (std::size_t b = 0; b < books.size(); ++b) {
+    if (books[b].allocation > static_cast<std::uint8_t>(Allocation::TopOrderProRata)) {
+      return invalid("unknown allocation");
+    }
+    if (books[b].level_count > levels.size() - level) {
+      return invalid("level count mismatch");
+    }
+    const std::size_t end = level + books[b].level_count;
+    for (std::size_t l = level; l < end; ++l) {
+      const SnapshotLevel &record = levels[l];
+      if (record.side > static_cast<std::uint8_t>(Side::SELL) || record.order_count == 0 ||
+          std::isnan(record.price)) {
+        return invalid("bad level");
+      }
+      // Bids then asks, each side strictly best first.
+      if (l > level) {
+        const SnapshotLevel &prev = levels[l - 1];
+        bool ordered = prev.side != record.side
+                           ? prev.side < record.side
+                           : (record.side == static_cast<std::uint8_t>(Side::BUY)
+                                  ? prev.price > record.price
+                                  : prev.price < record.price);
+        if (!ordered) {
+          return invalid("levels out of order");
+        }
+      }
+      if (record.order_count > orders.size() - order) {
+        return invalid("order count mismatch");
+      }
+      for (std::size_t o = order; o < order + record.order_count; ++o) {
+        if (orders[o].type > static_cast<std::uint8_t>(OrderType::IOC)) {
+          return invalid("bad order");
+        }
+      }
+      order += record.order_count;
+    }
+    level = end;
+    first_level[b + 1] = level;
+    first_order[b + 1] = order;
+    sizes[b] = first_order[b + 1] - first_order[b];
+  }
+  if (level != levels.size() || order != orders.size()) {
+    return invalid("count mismatch");
+  }
+
+  // Books are created here, as in bulk_insert(); each is then filled by one
+  // thread, level by level in saved order, so no level needs sorting.
+  std::vector<AnyOrderBook *> created(books.size());
+  for (std::size_t b = 0; b < books.size(); ++b) {
+    created[b] = &new_book(symbols[b], symbol_hash(symbols[b]),
+                           static_cast<Allocation>(books[b].allocation));
+  }
+  std::atomic<bool> restored{true};
+  for_each_parallel(sizes, threads, [&](std::size_t b) {
+    const std::string symbol(symbols[b]);
+    const std::uint64_t hash = symbol_hash(symbol);
+    std::size_t o = first_order[b];
+    std::visit(
+        [&](auto &symbol_book) {
+          for (std::size_t l = first_level[b]; l < first_level[b + 1]; ++l) {
+            const SnapshotLevel &record = levels[l];
+            const auto side = static_cast<Side>(record.side);
+            PriceLevel restored_level;
+            restored_level.top_order_live = record.top_order_live != 0;
+            for (const std::size_t end = o + record.order_count; o < end; ++o) {
+              restored_level.orders.push_back({orders[o].id, symbol, side, record.price,
+                                               orders[o].quantity,
+                                               static_cast<OrderType>(orders[o].type), hash});
+            }
+            if (!symbol_book.append_level(side, record.price, std::move(restored_level))) {
+              restored.store(false, std::memory_order_relaxed);
+            }
+          }
+        },
+        *created[b]);
+  });
+  if (!restored.load()) {
+    // Unreachable after the validation above; keep the promise to leave
+    // the engine empty all the same.
+    books_ = SymbolMap<AnyOrderBook>{};
+    return invalid("levels out of order");
+  }
+  sequence_ = header.sequence;
+  return true;
+}
+
+} // namespace fm
@@ -11,7 +11,7 @@ void stream_csv(const std::string &filename) {
   Order order;
 
   while (std::getline(file, line)) {
-    if (parse_order_line(line, order)) {
+    if (fm::parse_order_line(line, order)) {
       push_to_ring_buffer(order); // Directly process or enqueue
     }
   }
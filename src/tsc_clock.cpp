@@ -0,0 +1,70 @@
+#include "flashmatch/tsc_clock.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if FLASHMATCH_HAVE_RDTSC
+#include <cpuid.h>
+#endif
+
+namespace fm {
+
+bool TscClock::invariant_tsc_available() {
+#if FLASHMATCH_HAVE_RDTSC
+  unsigned eax, ebx, ecx, edx;
+  if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+    return false;
+  }
+  __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+  return (edx & (1u << 8)) != 0;
+#else
+  return false;
+#endif
+}
+
+TscClock::TscClock(bool use_tsc, int calibration_ms) {
+  if (!use_tsc || !invariant_tsc_available()) {
+    return;
+  }
+#if FLASHMATCH_HAVE_RDTSC
+  tsc_ = true;
+  // Bracket each steady_clock read with TSC reads and take the midpoint so
+  // the vDSO call cost cancels out of the ratio.
+  auto sample = [this](std::uint64_t &ticks, std::uint64_t &ns) {
+    std::uint64_t before = start();
+    ns = steady_ns();
+    std::uint64_t after = stop();
+    ticks = before + (after - before) / 2;
+  };
+  std::uint64_t tick0, ns0, tick1, ns1;
+  sample(tick0, ns0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(calibration_ms));
+  sample(tick1, ns1);
+  if (tick1 <= tick0 || ns1 <= ns0) {
+    tsc_ = false;
+    return;
+  }
+  ns_per_tick_ = static_cast<double>(ns1 - ns0) / static_cast<double>(tick1 - tick0);
+#endif
+}
+
+const TscClock &TscClock::instance() {
+  static const TscClock clock([] {
+    const char *mode = std::getenv("FLASHMATCH_CLOCK");
+    return mode == nullptr || std::strcmp(mode, "steady") != 0;
+  }());
+  return clock;
+}
+
+std::string TscClock::describe() const {
+  if (!tsc_) {
+    return "steady_clock";
+  }
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "tsc (%.2f GHz)", 1.0 / ns_per_tick_);
+  return buf;
+}
+
+} // namespace fm
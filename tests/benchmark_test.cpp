@@ -1,15 +1,30 @@
 // Benchmark tests for Flashmatch
 
+#include "flashmatch/bench_results.hpp"
 #include "flashmatch/benchmark.hpp"
+#include "flashmatch/order_generator.hpp"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <ctime>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <thread>
+#include <vector>
 
-// Location of the benchmark dataset within the repository root.
+// Benchmarks replay datasets/ob_100mil_bench_20mil_warm.csv when it has been
+// generated, and otherwise run on the same-sized in-process order flow.
+// FLASHMATCH_BENCH_ORDERS scales the generated run down for quick checks.
+//
+// NoRegressionAgainstBaseline appends its runs to FLASHMATCH_BENCH_RESULTS
+// when it is set. Point FLASHMATCH_BENCH_BASELINE at an earlier results file
+// to fail on any metric that moved beyond run-to-run noise.
+// FLASHMATCH_BENCH_REPEAT sets the number of runs (default 1, or 3 against a
+// baseline, so the comparison has a spread to judge noise by).
 class BenchmarkTest : public ::testing::Test {
 protected:
   static constexpr const char *kData = "ob_100mil_bench_20mil_warm.csv";
@@ -19,44 +34,115 @@ protected:
            kData;
   }
 
-  static void SetUpTestSuite() {
-    auto path = dataset_path();
-    if (!std::filesystem::exists(path)) {
-      std::string cmd =
-          "(cd " +
-          (std::filesystem::path(__FILE__).parent_path() / ".." / "datasets")
-              .string() +
-          " && python3 generate_orderbook.py)";
-      int result = std::system(cmd.c_str());
-      ASSERT_EQ(result, 0) << "Dataset generation failed with code " << result;
+  static bool have_dataset() { return std::filesystem::exists(dataset_path()); }
+
+  static fm::GeneratorConfig generator_config() {
+    fm::GeneratorConfig config;
+    if (const char *orders = std::getenv("FLASHMATCH_BENCH_ORDERS")) {
+      config.total_orders = std::strtoull(orders, nullptr, 10);
+      config.warmup_orders = config.total_orders / 6;
     }
-    ASSERT_TRUE(std::filesystem::exists(path))
-        << "Dataset missing after generation";
+    return config;
+  }
+
+  static fm::BenchStats run_bench() {
+    return have_dataset() ? fm::run_bench(dataset_path().string())
+                          : fm::run_bench(generator_config());
+  }
+
+  static std::string source() {
+    if (have_dataset()) {
+      return kData;
+    }
+    fm::GeneratorConfig config = generator_config();
+    return "generated:" + std::to_string(config.total_orders) + ":seed" +
+           std::to_string(config.seed);
+  }
+
+  static std::string env_or(const char *name, const char *fallback) {
+    const char *value = std::getenv(name);
+    return value != nullptr && *value != '\0' ? value : fallback;
+  }
+
+  static double run_engine_bench() {
+    return have_dataset() ? fm::run_engine_bench(dataset_path().string())
+                          : fm::run_engine_bench(generator_config());
   }
 };
 
-TEST_F(BenchmarkTest, MeanLatencyUnder15us) {
-  fm::BenchStats stats = fm::run_bench(dataset_path().string());
-  ASSERT_GT(stats.num_orders, 0);
-  ASSERT_LT(stats.p99_latency, 40000);
-  fm::output_stats(stats);
-  ASSERT_LT(stats.mean_latency, 15.0)
-      << "Mean latency exceeded 15us. Target: 15us, Actual: " << stats.mean_latency;
+TEST_F(BenchmarkTest, NoRegressionAgainstBaseline) {
+  const std::string results_path = env_or("FLASHMATCH_BENCH_RESULTS", "");
+  const std::string baseline_path = env_or("FLASHMATCH_BENCH_BASELINE", "");
+  const int repeat = std::max(
+      1, std::atoi(env_or("FLASHMATCH_BENCH_REPEAT", baseline_path.empty() ? "1" : "3").c_str()));
+
+  fm::BenchRecord record;
+  record.source = source();
+  record.mode = "submit";
+  record.environment = fm::bench_environment();
+  std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  char timestamp[32];
+  std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  record.timestamp = timestamp;
+
+  std::vector<fm::BenchRecord> records;
+  std::ofstream results;
+  if (!results_path.empty()) {
+    results.open(results_path, std::ios::app);
+  }
+  for (int run = 0; run < repeat; ++run) {
+    record.run = run;
+    record.stats = run_bench();
+    ASSERT_GT(record.stats.num_orders, 0);
+    ASSERT_LT(record.stats.p99_latency, 40000);
+    fm::output_stats(record.stats);
+    if (results.is_open()) {
+      fm::write_record_json(results, record);
+    }
+    records.push_back(record);
+  }
+  if (results.is_open()) {
+    std::cout << "Results appended to " << results_path << std::endl;
+  }
+
+  if (baseline_path.empty()) {
+    return;
+  }
+  std::vector<fm::BenchRecord> baseline;
+  for (const fm::BenchRecord &base : fm::read_records_json(baseline_path)) {
+    if (base.mode == record.mode && base.source == record.source) {
+      baseline.push_back(base);
+    }
+  }
+  ASSERT_FALSE(baseline.empty()) << "No " << record.source << " runs in " << baseline_path;
+  std::vector<fm::MetricDelta> deltas = fm::compare_records(baseline, records);
+  fm::output_comparison(deltas, baseline.size(), records.size());
+  EXPECT_FALSE(fm::has_regression(deltas)) << "Regression against " << baseline_path;
 }
 
 TEST_F(BenchmarkTest, EngineRunTiming) {
-  double time_us = fm::run_engine_bench(dataset_path().string());
+  double time_us = run_engine_bench();
   ASSERT_GT(time_us, 0) << "Engine benchmark did not run";
   std::cout << "Engine.run() time: " << time_us << " micro-seconds" << std::endl;
 }
 
 TEST_F(BenchmarkTest, TotalLoopTime) {
-  fm::BenchStats stats = fm::run_bench(dataset_path().string());
+  fm::BenchStats stats = run_bench();
   ASSERT_GT(stats.num_orders, 0);
   ASSERT_LT(stats.p99_latency, 40000);
   std::cout << "Total loop time: " << stats.total_time_us << " micro-seconds" << std::endl;
 }
 
+TEST_F(BenchmarkTest, ParseThroughput) {
+  if (!have_dataset()) {
+    GTEST_SKIP() << "Parse benchmark needs " << kData;
+  }
+  fm::ParseStats stats = fm::run_parse_bench(dataset_path().string());
+  ASSERT_GT(stats.rows, 0);
+  fm::output_parse_stats(stats);
+  EXPECT_TRUE(stats.results_match) << "SIMD parser disagrees with the baseline parser";
+}
+
 TEST(Benchmark, LatencyGuardRegression) {
   using namespace std::chrono;
   auto start = steady_clock::now();
@@ -0,0 +1,61 @@
+#ifndef FLASHMATCH_TESTS_ENGINE_TEST_HELPERS_HPP
+#define FLASHMATCH_TESTS_ENGINE_TEST_HELPERS_HPP
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "flashmatch/matching_engine.hpp"
+#include "flashmatch/order_generator.hpp"
+
+namespace fm::test {
+
+// `count` generated orders over `symbols` symbols, with no warmup.
+inline std::vector<Order> generate_orders(std::size_t count, std::size_t symbols) {
+  GeneratorConfig config;
+  config.total_orders = count;
+  config.warmup_orders = 0;
+  config.symbol_count = symbols;
+  std::vector<Order> orders;
+  OrderGenerator(config).for_each_batch([&](std::span<const Order> batch) {
+    orders.insert(orders.end(), batch.begin(), batch.end());
+    return true;
+  });
+  return orders;
+}
+
+// Generated warmup and measured orders over `symbols` symbols.
+inline void generate_flow(std::size_t symbols, std::vector<Order> &warmup,
+                          std::vector<Order> &measured) {
+  GeneratorConfig config;
+  config.total_orders = 12000;
+  config.warmup_orders = 6000;
+  config.symbol_count = symbols;
+  OrderGenerator(config).for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      (warmup.size() < config.warmup_orders ? warmup : measured).push_back(order);
+    }
+    return true;
+  });
+}
+
+// Submits orders to both engines, expecting identical trades.
+inline void expect_same_trades(MatchingEngine &expected_engine, MatchingEngine &engine,
+                               std::span<const Order> orders) {
+  for (const Order &order : orders) {
+    auto expected = expected_engine.submit(order);
+    auto actual = engine.submit(order);
+    ASSERT_EQ(actual.size(), expected.size()) << order.id;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(actual[i].maker_id, expected[i].maker_id);
+      EXPECT_EQ(actual[i].quantity, expected[i].quantity);
+      EXPECT_EQ(actual[i].price, expected[i].price);
+    }
+  }
+}
+
+} // namespace fm::test
+
+#endif // FLASHMATCH_TESTS_ENGINE_TEST_HELPERS_HPP
@@ -0,0 +1,98 @@
+#include "flashmatch/allocation.hpp"
+
+#include <gtest/gtest.h>
+
+#include <variant>
+#include <vector>
+
+#include "flashmatch/matching_engine.hpp"
+
+using namespace fm;
+
+namespace {
+
+Order limit(std::uint64_t id, Side side, double price, std::uint64_t quantity,
+            const char *symbol = "ED") {
+  return Order{id, symbol, side, price, quantity, OrderType::LIMIT};
+}
+
+} // namespace
+
+TEST(AllocationTest, ProRataSplitIsProportional) {
+  std::vector<std::uint64_t> sizes = {100, 300, 600};
+  std::vector<std::uint64_t> shares(3);
+  pro_rata_split(sizes, 1000, 500, shares);
+  EXPECT_EQ(shares, (std::vector<std::uint64_t>{50, 150, 300}));
+
+  // Leftover lots after rounding down go out in time priority.
+  sizes = {1, 1, 1};
+  pro_rata_split(sizes, 3, 2, shares);
+  EXPECT_EQ(shares, (std::vector<std::uint64_t>{1, 1, 0}));
+}
+
+TEST(AllocationTest, ProRataBookSharesTheLevel) {
+  ProRataOrderBook book;
+  book.insertOrder(limit(1, Side::SELL, 10.0, 100));
+  book.insertOrder(limit(2, Side::SELL, 10.0, 300));
+
+  auto trades = book.match(limit(3, Side::BUY, 10.0, 200));
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[0].maker_id, 1u);
+  EXPECT_EQ(trades[0].quantity, 50u);
+  EXPECT_EQ(trades[1].maker_id, 2u);
+  EXPECT_EQ(trades[1].quantity, 150u);
+
+  // The rest of the level, then 50 left over to rest.
+  trades = book.match(limit(4, Side::BUY, 10.0, 250));
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_EQ(trades[0].quantity, 50u);
+  EXPECT_EQ(trades[1].quantity, 150u);
+  trades = book.match(limit(5, Side::SELL, 10.0, 50));
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].maker_id, 4u);
+}
+
+TEST(AllocationTest, TopOrderFillsFirst) {
+  TopOrderProRataOrderBook book;
+  book.insertOrder(limit(1, Side::SELL, 10.0, 100)); // New best ask: top order.
+  book.insertOrder(limit(2, Side::SELL, 10.0, 100));
+  book.insertOrder(limit(3, Side::SELL, 10.0, 200));
+
+  auto trades = book.match(limit(4, Side::BUY, 10.0, 200));
+  ASSERT_EQ(trades.size(), 3u);
+  EXPECT_EQ(trades[0].maker_id, 1u);
+  EXPECT_EQ(trades[0].quantity, 100u);
+  // 100 left for 100 + 200 resting: 33 and 66, plus one leftover lot.
+  EXPECT_EQ(trades[1].quantity, 34u);
+  EXPECT_EQ(trades[2].quantity, 66u);
+
+  // A level opened behind the best price has no top order.
+  TopOrderProRataOrderBook behind;
+  behind.insertOrder(limit(1, Side::SELL, 10.0, 10));
+  behind.insertOrder(limit(2, Side::SELL, 11.0, 100));
+  behind.insertOrder(limit(3, Side::SELL, 11.0, 100));
+  trades = behind.match(limit(4, Side::BUY, 11.0, 110));
+  ASSERT_EQ(trades.size(), 3u);
+  EXPECT_EQ(trades[1].quantity, 50u);
+  EXPECT_EQ(trades[2].quantity, 50u);
+}
+
+TEST(AllocationTest, EngineRulesPickPolicyPerSymbol) {
+  Allocation parsed;
+  ASSERT_TRUE(parse_allocation("pro_rata", parsed));
+  EXPECT_EQ(parsed, Allocation::ProRata);
+  EXPECT_FALSE(parse_allocation("lifo", parsed));
+
+  AllocationRules rules;
+  rules.prefixes = {{"ED", Allocation::ProRata}};
+  MatchingEngine engine(rules);
+  for (const char *symbol : {"EDZ6", "AAPL"}) {
+    engine.insert(limit(1, Side::SELL, 10.0, 100, symbol));
+    engine.insert(limit(2, Side::SELL, 10.0, 100, symbol));
+  }
+  EXPECT_TRUE(std::holds_alternative<ProRataOrderBook>(*engine.find_book("EDZ6")));
+  EXPECT_TRUE(std::holds_alternative<OrderBook>(*engine.find_book("AAPL")));
+
+  EXPECT_EQ(engine.submit(limit(3, Side::BUY, 10.0, 100, "EDZ6")).size(), 2u);
+  EXPECT_EQ(engine.submit(limit(3, Side::BUY, 10.0, 100, "AAPL")).size(), 1u);
+}
@@ -0,0 +1,155 @@
+#include "flashmatch/bench_results.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace fm;
+
+namespace {
+
+BenchRecord make_record(double mean, double orders_per_sec, int run = 0) {
+  BenchRecord record;
+  record.source = "generated";
+  record.mode = "submit";
+  record.run = run;
+  record.stats.num_orders = 1000;
+  record.stats.mean_latency = mean;
+  record.stats.p50_latency = mean;
+  record.stats.p95_latency = mean;
+  record.stats.p99_latency = mean;
+  record.stats.p999_latency = mean;
+  record.stats.p9999_latency = mean;
+  record.stats.worst_latency_us = mean * 10;
+  record.stats.total_time_us = 1000 * 1e6 / orders_per_sec;
+  return record;
+}
+
+const MetricDelta *find(const std::vector<MetricDelta> &deltas, const std::string &metric) {
+  for (const MetricDelta &delta : deltas) {
+    if (delta.metric == metric) {
+      return &delta;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+TEST(BenchResultsTest, RecordsSerializeEveryField) {
+  BenchRecord record;
+  record.timestamp = "2024-01-01T00:00:00Z";
+  record.source = "data,set.csv";
+  record.mode = "submit";
+  record.run = 2;
+  record.stats.num_orders = 10;
+  record.stats.p99999_latency = 4.5;
+  record.stats.timer = "tsc (3.00 GHz)";
+  record.environment = bench_environment();
+  EXPECT_FALSE(record.environment.cpu_model.empty());
+  EXPECT_FALSE(record.environment.compile_flags.empty());
+  EXPECT_FALSE(record.environment.git_revision.empty());
+  EXPECT_FALSE(record.environment.kernel.empty());
+
+  std::ostringstream json;
+  write_record_json(json, record);
+  EXPECT_NE(json.str().find(R"("source":"data,set.csv")"), std::string::npos);
+  EXPECT_NE(json.str().find(R"("run":2)"), std::string::npos);
+  EXPECT_NE(json.str().find(R"("p99999_us":4.5)"), std::string::npos);
+  EXPECT_NE(json.str().find(R"("git":)"), std::string::npos);
+  EXPECT_EQ(json.str().back(), '\n');
+
+  std::ostringstream header, row;
+  write_record_csv_header(header);
+  write_record_csv(row, record);
+  auto columns = [](const std::string &line) {
+    std::size_t count = 1;
+    bool quoted = false;
+    for (char c : line) {
+      quoted ^= (c == '"');
+      count += (c == ',' && !quoted);
+    }
+    return count;
+  };
+  EXPECT_EQ(columns(header.str()), columns(row.str()));
+  EXPECT_NE(row.str().find("\"data,set.csv\""), std::string::npos);
+}
+
+TEST(BenchResultsTest, JsonRoundTrip) {
+  BenchRecord record = make_record(0.25, 4e6, 1);
+  record.source = "a \"quoted\" name";
+  record.stats.p99999_latency = 7.5;
+  record.stats.timer = "steady_clock";
+  record.stats.bench_counters.present[static_cast<std::size_t>(PerfEvent::Cycles)] = true;
+  record.stats.bench_counters.values[static_cast<std::size_t>(PerfEvent::Cycles)] = 512000;
+  record.environment.host = "bench01";
+  record.environment.git_revision = "abc1234-dirty";
+
+  auto path = std::filesystem::temp_directory_path() / "flashmatch_results_test.jsonl";
+  {
+    std::ofstream out(path);
+    write_record_json(out, record);
+    out << "not json\n";
+    write_record_json(out, make_record(0.5, 2e6));
+  }
+  std::vector<BenchRecord> records = read_records_json(path.string());
+  std::remove(path.string().c_str());
+
+  ASSERT_EQ(records.size(), 2u);
+  const BenchRecord &r = records[0];
+  EXPECT_EQ(r.source, record.source);
+  EXPECT_EQ(r.mode, "submit");
+  EXPECT_EQ(r.run, 1);
+  EXPECT_EQ(r.stats.num_orders, 1000u);
+  EXPECT_DOUBLE_EQ(r.stats.mean_latency, 0.25);
+  EXPECT_DOUBLE_EQ(r.stats.p99999_latency, 7.5);
+  EXPECT_NEAR(r.stats.total_time_us, record.stats.total_time_us, 1e-3);
+  EXPECT_EQ(r.stats.timer, "steady_clock");
+  EXPECT_TRUE(r.stats.bench_counters.has(PerfEvent::Cycles));
+  EXPECT_FALSE(r.stats.bench_counters.has(PerfEvent::Instructions));
+  EXPECT_EQ(r.stats.bench_counters[PerfEvent::Cycles], 512000u);
+  EXPECT_EQ(r.environment.host, "bench01");
+  EXPECT_EQ(r.environment.git_revision, "abc1234-dirty");
+  EXPECT_TRUE(read_records_json("/nonexistent/results.jsonl").empty());
+}
+
+TEST(BenchResultsTest, FlagsChangesBeyondNoise) {
+  std::vector<BenchRecord> baseline = {make_record(1.0, 1e6), make_record(1.02, 1e6),
+                                       make_record(0.98, 1e6)};
+  // Mean 20% slower, throughput 20% higher.
+  std::vector<BenchRecord> current = {make_record(1.2, 1.2e6), make_record(1.2, 1.2e6)};
+  std::vector<MetricDelta> deltas = compare_records(baseline, current);
+
+  const MetricDelta *mean = find(deltas, "mean us");
+  ASSERT_NE(mean, nullptr);
+  EXPECT_DOUBLE_EQ(mean->baseline, 1.0);
+  EXPECT_NEAR(mean->delta_pct, 20.0, 1e-9);
+  EXPECT_EQ(mean->verdict, Verdict::Regressed);
+  const MetricDelta *throughput = find(deltas, "orders/s");
+  ASSERT_NE(throughput, nullptr);
+  EXPECT_EQ(throughput->verdict, Verdict::Improved);
+  EXPECT_TRUE(has_regression(deltas));
+  // Counters were not collected, so they are not compared.
+  EXPECT_EQ(find(deltas, "cycles"), nullptr);
+}
+
+TEST(BenchResultsTest, NoisyBaselineWidensThreshold) {
+  // +-25% spread across baseline runs: a 20% move is within noise.
+  std::vector<BenchRecord> baseline = {make_record(0.75, 1e6), make_record(1.0, 1e6),
+                                       make_record(1.25, 1e6)};
+  std::vector<BenchRecord> current = {make_record(1.2, 1e6)};
+  std::vector<MetricDelta> deltas = compare_records(baseline, current);
+  const MetricDelta *mean = find(deltas, "mean us");
+  ASSERT_NE(mean, nullptr);
+  EXPECT_NEAR(mean->threshold_pct, 50.0, 1e-9);
+  EXPECT_EQ(mean->verdict, Verdict::Unchanged);
+  EXPECT_FALSE(has_regression(deltas));
+
+  // Small moves stay below the floor even with no noise at all.
+  deltas = compare_records({make_record(1.0, 1e6)}, {make_record(1.03, 1e6)});
+  EXPECT_FALSE(has_regression(deltas));
+  EXPECT_TRUE(compare_records({}, current).empty());
+}
@@ -0,0 +1,86 @@
+#include "flashmatch/binary_dataset.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "flashmatch/dataset_reader.hpp"
+
+using namespace fm;
+
+namespace {
+
+std::vector<Order> read_all(const std::string &path, DatasetHeader &header) {
+  std::vector<Order> orders;
+  DatasetReader reader(path, 2, 256);
+  EXPECT_TRUE(reader.is_open()) << path;
+  header = reader.header();
+  EXPECT_TRUE(reader.for_each_batch([&](std::span<const Order> batch) {
+    orders.insert(orders.end(), batch.begin(), batch.end());
+    return true;
+  }));
+  return orders;
+}
+
+} // namespace
+
+TEST(BinaryDatasetTest, RoundTripsCsvDataset) {
+  auto dir = std::filesystem::temp_directory_path();
+  auto csv = dir / "fm_binary_roundtrip.csv";
+  auto bin = dir / "fm_binary_roundtrip.bin";
+  {
+    std::ofstream out(csv, std::ios::trunc);
+    out << "1000,400\n";
+    const char *symbols[] = {"AAPL", "GOOG", "MSFT", "TSLA", "BRK.B"};
+    for (int i = 1; i <= 1000; ++i) {
+      out << i << "," << symbols[i % 5] << "," << (i % 2 ? "BUY" : "SELL") << "," << 9.5 + i * 0.01
+          << "," << i % 100 + 1 << "," << (i > 400 && i % 3 == 0 ? "IOC" : "LIMIT") << "\n";
+    }
+  }
+  ASSERT_TRUE(convert_csv_to_binary(csv.string(), bin.string(), 2));
+
+  DatasetHeader csv_header;
+  DatasetHeader bin_header;
+  auto from_csv = read_all(csv.string(), csv_header);
+  auto from_bin = read_all(bin.string(), bin_header);
+
+  EXPECT_EQ(bin_header.total_rows, 1000u);
+  EXPECT_EQ(bin_header.warmup_rows, 400u);
+  ASSERT_EQ(from_csv.size(), from_bin.size());
+  for (std::size_t i = 0; i < from_csv.size(); ++i) {
+    EXPECT_EQ(from_csv[i].id, from_bin[i].id);
+    EXPECT_EQ(from_csv[i].symbol, from_bin[i].symbol);
+    EXPECT_EQ(from_csv[i].side, from_bin[i].side);
+    EXPECT_EQ(from_csv[i].price, from_bin[i].price);
+    EXPECT_EQ(from_csv[i].quantity, from_bin[i].quantity);
+    EXPECT_EQ(from_csv[i].type, from_bin[i].type);
+  }
+
+  MappedFile file(bin.string());
+  BinaryDatasetView view;
+  ASSERT_TRUE(view.open(file.view()));
+  EXPECT_EQ(view.symbols().size(), 5u);
+  EXPECT_EQ(view.records().size(), 1000u);
+
+  std::filesystem::remove(csv);
+  std::filesystem::remove(bin);
+}
+
+TEST(BinaryDatasetTest, RejectsTruncatedFile) {
+  auto path = std::filesystem::temp_directory_path() / "fm_binary_truncated.bin";
+  {
+    BinaryDatasetWriter writer(path.string(), DatasetHeader{2, 0}, {"AAPL"});
+    ASSERT_TRUE(writer.is_open());
+    EXPECT_TRUE(writer.append(Order{1, "AAPL", Side::BUY, 10.0, 5, OrderType::LIMIT}));
+    EXPECT_FALSE(writer.append(Order{2, "GOOG", Side::BUY, 10.0, 5, OrderType::LIMIT}));
+    EXPECT_TRUE(writer.append(Order{3, "AAPL", Side::SELL, 10.0, 5, OrderType::LIMIT}));
+    ASSERT_TRUE(writer.finish());
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  DatasetReader reader(path.string());
+  EXPECT_FALSE(reader.is_open());
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,109 @@
+#include "flashmatch/high_perf_csv_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace fm;
+
+TEST(CsvParserTest, ClassifyBlockFindsDelimiters) {
+  std::string block = "1,AAPL,BUY,10.25,100,LIMIT\n2,GOO";
+  ASSERT_EQ(block.size(), 32u);
+  DelimiterMask mask = classify_block(block.data());
+  std::uint32_t commas = 0;
+  std::uint32_t newlines = 0;
+  for (std::size_t i = 0; i < block.size(); ++i) {
+    commas |= static_cast<std::uint32_t>(block[i] == ',') << i;
+    newlines |= static_cast<std::uint32_t>(block[i] == '\n') << i;
+  }
+  EXPECT_EQ(mask.commas, commas);
+  EXPECT_EQ(mask.newlines, newlines);
+}
+
+TEST(CsvParserTest, ParsePriceMatchesStrtod) {
+  const std::vector<std::string> prices = {
+      "10", "9.5", "10.50", "0.01", "9.99", "-12.75", "123456.789", "0.1", "+3.25"};
+  for (const auto &text : prices) {
+    double value = 0.0;
+    ASSERT_TRUE(parse_price(text, value)) << text;
+    EXPECT_EQ(value, std::strtod(text.c_str(), nullptr)) << text;
+  }
+}
+
+TEST(CsvParserTest, ParsePriceFallsBackForExponents) {
+  double value = 0.0;
+  ASSERT_TRUE(parse_price("1.5e2", value));
+  EXPECT_EQ(value, 150.0);
+  ASSERT_TRUE(parse_price("12345678901234567890.5", value));
+  EXPECT_EQ(value, std::strtod("12345678901234567890.5", nullptr));
+}
+
+TEST(CsvParserTest, ParsePriceRejectsGarbage) {
+  double value = 0.0;
+  EXPECT_FALSE(parse_price("", value));
+  EXPECT_FALSE(parse_price("abc", value));
+  EXPECT_FALSE(parse_price("10.5x", value));
+  EXPECT_FALSE(parse_price(".", value));
+}
+
+TEST(CsvParserTest, ParsePriceStopsAtViewEnd) {
+  // The view ends before the trailing digits, which must not be read.
+  std::string text = "10.25999";
+  double value = 0.0;
+  ASSERT_TRUE(parse_price(std::string_view(text).substr(0, 5), value));
+  EXPECT_EQ(value, 10.25);
+}
+
+TEST(CsvParserTest, ParseOrderLine) {
+  Order order;
+  ASSERT_TRUE(parse_order_line("42,MSFT,SELL,9.87,15,IOC", order));
+  EXPECT_EQ(order.id, 42u);
+  EXPECT_EQ(order.symbol, "MSFT");
+  EXPECT_EQ(order.side, Side::SELL);
+  EXPECT_EQ(order.price, 9.87);
+  EXPECT_EQ(order.quantity, 15u);
+  EXPECT_EQ(order.type, OrderType::IOC);
+}
+
+TEST(CsvParserTest, ParseOrderLineRejectsWrongFieldCount) {
+  Order order;
+  EXPECT_FALSE(parse_order_line("1,AAPL,BUY,10.0,100", order));
+  EXPECT_FALSE(parse_order_line("1,AAPL,BUY,10.0,100,LIMIT,extra", order));
+  EXPECT_FALSE(parse_order_line("x,AAPL,BUY,10.0,100,LIMIT", order));
+}
+
+TEST(CsvParserTest, ScannerWalksRowsAcrossBlocks) {
+  std::string data;
+  for (int i = 1; i <= 100; ++i) {
+    data += std::to_string(i) + ",TSLA," + (i % 2 ? "BUY" : "SELL") + ",10." +
+            std::to_string(i % 100) + "," + std::to_string(i * 3) + "," +
+            (i % 3 ? "LIMIT" : "IOC") + (i % 7 ? "\n" : "\r\n");
+  }
+  // Last row has no trailing newline.
+  data += "101,TSLA,BUY,9.5,7,LIMIT";
+
+  CsvOrderScanner scanner(data.data(), data.data() + data.size());
+  Order order;
+  std::uint64_t expected = 1;
+  while (scanner.next(order)) {
+    EXPECT_EQ(order.id, expected);
+    EXPECT_EQ(order.symbol, "TSLA");
+    ++expected;
+  }
+  EXPECT_FALSE(scanner.failed());
+  EXPECT_EQ(expected, 102u);
+  EXPECT_EQ(order.price, 9.5);
+  EXPECT_EQ(order.type, OrderType::LIMIT);
+}
+
+TEST(CsvParserTest, ScannerReportsMalformedRow) {
+  std::string data = "1,AAPL,BUY,10.0,5,LIMIT\n\n2,AAPL,BUY\n3,AAPL,SELL,10.0,5,LIMIT\n";
+  CsvOrderScanner scanner(data.data(), data.data() + data.size());
+  Order order;
+  ASSERT_TRUE(scanner.next(order));
+  EXPECT_FALSE(scanner.next(order));
+  EXPECT_TRUE(scanner.failed());
+  EXPECT_EQ(scanner.last_line(), "2,AAPL,BUY");
+}
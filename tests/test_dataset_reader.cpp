@@ -0,0 +1,97 @@
+#include "flashmatch/dataset_reader.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace fm;
+
+namespace {
+
+std::filesystem::path write_dataset(const std::string &name, std::size_t rows, std::size_t warmup) {
+  auto path = std::filesystem::temp_directory_path() / name;
+  std::ofstream out(path, std::ios::trunc);
+  out << rows << "," << warmup << "\n";
+  for (std::size_t i = 1; i <= rows; ++i) {
+    out << i << "," << (i % 3 == 0 ? "GOOG" : "AAPL") << "," << (i % 2 ? "BUY" : "SELL") << ",10."
+        << (i % 50) << "," << (i % 100 + 1) << "," << (i <= warmup ? "LIMIT" : "IOC") << "\n";
+  }
+  return path;
+}
+
+} // namespace
+
+TEST(DatasetReaderTest, ParsesHeader) {
+  DatasetHeader header;
+  ASSERT_TRUE(parse_dataset_header("120000000,20000000", header));
+  EXPECT_EQ(header.total_rows, 120000000u);
+  EXPECT_EQ(header.warmup_rows, 20000000u);
+  EXPECT_FALSE(parse_dataset_header("120000000", header));
+  EXPECT_FALSE(parse_dataset_header("12,x", header));
+}
+
+TEST(DatasetReaderTest, DeliversChunksInFileOrder) {
+  auto path = write_dataset("fm_dataset_reader_order.csv", 20000, 5000);
+  // Small chunks and several threads force many out-of-order completions.
+  DatasetReader reader(path.string(), 4, 1024);
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.header().total_rows, 20000u);
+  EXPECT_EQ(reader.header().warmup_rows, 5000u);
+
+  std::uint64_t expected = 1;
+  std::size_t batches = 0;
+  bool ok = reader.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      EXPECT_EQ(order.id, expected);
+      ++expected;
+    }
+    ++batches;
+    return true;
+  });
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(expected, 20001u);
+  EXPECT_GT(batches, 1u);
+  std::filesystem::remove(path);
+}
+
+TEST(DatasetReaderTest, SinkCanStopEarly) {
+  auto path = write_dataset("fm_dataset_reader_stop.csv", 10000, 0);
+  DatasetReader reader(path.string(), 3, 512);
+  ASSERT_TRUE(reader.is_open());
+  std::size_t seen = 0;
+  EXPECT_TRUE(reader.for_each_batch([&](std::span<const Order> batch) {
+    seen += batch.size();
+    return seen < 100;
+  }));
+  EXPECT_GE(seen, 100u);
+  EXPECT_LT(seen, 10000u);
+  std::filesystem::remove(path);
+}
+
+TEST(DatasetReaderTest, ReportsMalformedRow) {
+  auto path = std::filesystem::temp_directory_path() / "fm_dataset_reader_bad.csv";
+  {
+    std::ofstream out(path, std::ios::trunc);
+    out << "3,0\n1,AAPL,BUY,10.0,5,LIMIT\n2,AAPL,oops\n3,AAPL,SELL,10.0,5,LIMIT\n";
+  }
+  DatasetReader reader(path.string(), 2, 8);
+  ASSERT_TRUE(reader.is_open());
+  std::vector<std::uint64_t> ids;
+  EXPECT_FALSE(reader.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      ids.push_back(order.id);
+    }
+    return true;
+  }));
+  EXPECT_EQ(reader.error_line(), "2,AAPL,oops");
+  EXPECT_EQ(ids, std::vector<std::uint64_t>{1});
+  std::filesystem::remove(path);
+}
+
+TEST(DatasetReaderTest, MissingFileIsNotOpen) {
+  DatasetReader reader("/nonexistent/fm_dataset.csv");
+  EXPECT_FALSE(reader.is_open());
+}
@@ -0,0 +1,114 @@
+#include "flashmatch/flight_recorder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <csignal>
+#include <filesystem>
+#include <thread>
+
+#include "flashmatch/matching_engine.hpp"
+
+using namespace fm;
+
+namespace {
+
+std::filesystem::path temp_path(const std::string &name) {
+  return std::filesystem::temp_directory_path() / name;
+}
+
+// This thread's events from a fresh dump, oldest first.
+std::vector<FlightEvent> dump_this_thread() {
+  auto path = temp_path("flashmatch_flight_test.fr");
+  EXPECT_TRUE(dump_flight_recorder(path.string()));
+  FlightDump dump;
+  EXPECT_TRUE(read_flight_dump(path.string(), dump));
+  std::filesystem::remove(path);
+  for (const auto &thread : dump.threads) {
+    if (thread.thread_id == static_cast<int>(gettid())) {
+      return thread.events;
+    }
+  }
+  return {};
+}
+
+} // namespace
+
+TEST(FlightRecorderTest, RecordsMatchSequence) {
+  OrderBook book;
+  book.insertOrder(Order{101, "FLIGHT", Side::SELL, 10.0, 30, OrderType::LIMIT});
+  book.match(Order{102, "FLIGHT", Side::BUY, 10.0, 50, OrderType::LIMIT});
+
+  std::vector<FlightEvent> events = dump_this_thread();
+  ASSERT_GE(events.size(), 8u);
+  std::vector<FlightEvent> tail(events.end() - 8, events.end());
+  const FlightEventType expected[] = {
+      FlightEventType::Rested,      FlightEventType::LevelCreated, FlightEventType::OrderReceived,
+      FlightEventType::Trade,       FlightEventType::LevelErased,  FlightEventType::Rested,
+      FlightEventType::LevelCreated, FlightEventType::Matched};
+  for (std::size_t i = 0; i < tail.size(); ++i) {
+    EXPECT_EQ(tail[i].type, expected[i]) << "event " << i;
+    EXPECT_STREQ(tail[i].symbol, "FLIGHT");
+    if (i > 0) {
+      EXPECT_GE(tail[i].tsc, tail[i - 1].tsc);
+    }
+  }
+  EXPECT_EQ(tail[3].order_id, 102u);
+  EXPECT_EQ(tail[3].other_id, 101u);
+  EXPECT_EQ(tail[3].quantity, 30u);
+  EXPECT_EQ(tail[5].quantity, 20u);
+  EXPECT_EQ(tail[5].side, static_cast<std::uint8_t>(Side::BUY));
+  EXPECT_EQ(tail[7].quantity, 30u);
+  EXPECT_EQ(tail[7].other_id, 1u);
+  // Events inside a match share its starting stamp.
+  EXPECT_EQ(tail[3].tsc, tail[2].tsc);
+}
+
+TEST(FlightRecorderTest, RingKeepsNewestEventsOnWrap) {
+  std::vector<FlightEvent> events;
+  std::thread writer([&] {
+    Order order{0, "WRAP", Side::BUY, 1.0, 1, OrderType::IOC};
+    for (std::uint64_t i = 1; i <= FlightRing::kEvents + 100; ++i) {
+      order.id = i;
+      FlightRecorder::stamp();
+      FlightRecorder::record(FlightEventType::OrderReceived, order, 1, 1.0);
+    }
+    events = dump_this_thread();
+  });
+  writer.join();
+  ASSERT_EQ(events.size(), FlightRing::kEvents);
+  EXPECT_EQ(events.front().order_id, 101u);
+  EXPECT_EQ(events.back().order_id, FlightRing::kEvents + 100);
+}
+
+TEST(FlightRecorderTest, DumpsOnSignal) {
+  auto path = temp_path("flashmatch_flight_signal.fr");
+  std::filesystem::remove(path);
+  ASSERT_TRUE(install_flight_recorder_signal(path.string(), SIGUSR2));
+  MatchingEngine engine;
+  engine.submit(Order{1, "SIGNAL", Side::BUY, 1.0, 1, OrderType::LIMIT});
+  std::raise(SIGUSR2);
+  FlightDump dump;
+  ASSERT_TRUE(read_flight_dump(path.string(), dump));
+  EXPECT_FALSE(dump.threads.empty());
+  EXPECT_GT(dump.ns_per_tick, 0.0);
+  std::filesystem::remove(path);
+  std::signal(SIGUSR2, SIG_DFL);
+}
+
+TEST(FlightRecorderTest, SpikeDumperDumpsOnceOverThreshold) {
+  auto prefix = temp_path("flashmatch_spike_test").string();
+  SpikeDumper spikes(prefix, 1000);
+  spikes.check(999);
+  EXPECT_EQ(spikes.dumps(), 0);
+  spikes.check(5000);
+  spikes.check(9000);
+  EXPECT_EQ(spikes.dumps(), 1);
+  EXPECT_TRUE(std::filesystem::exists(prefix + ".0.fr"));
+  EXPECT_FALSE(std::filesystem::exists(prefix + ".1.fr"));
+  std::filesystem::remove(prefix + ".0.fr");
+
+  FlightDump dump;
+  EXPECT_FALSE(read_flight_dump("/nonexistent.fr", dump));
+}
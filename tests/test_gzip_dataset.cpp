@@ -0,0 +1,99 @@
+#include "flashmatch/gzip_dataset.hpp"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace fm;
+
+namespace {
+
+std::string make_csv(std::size_t rows, std::size_t warmup) {
+  std::string csv = std::to_string(rows) + "," + std::to_string(warmup) + "\n";
+  for (std::size_t i = 1; i <= rows; ++i) {
+    csv += std::to_string(i) + (i % 2 ? ",AAPL,BUY,10.25," : ",MSFT,SELL,9.75,") +
+           std::to_string(i % 100 + 1) + (i <= warmup ? ",LIMIT\n" : ",IOC\n");
+  }
+  return csv;
+}
+
+void write_gzip(const std::filesystem::path &path, const std::vector<std::string> &members) {
+  std::ofstream(path, std::ios::trunc).close();
+  for (const auto &member : members) {
+    gzFile file = gzopen(path.string().c_str(), "ab");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(gzwrite(file, member.data(), static_cast<unsigned>(member.size())),
+              static_cast<int>(member.size()));
+    gzclose(file);
+  }
+}
+
+std::vector<std::uint64_t> read_ids(const std::string &path, bool &ok, std::string &error) {
+  std::vector<std::uint64_t> ids;
+  DatasetReader reader(path);
+  EXPECT_TRUE(reader.is_open());
+  ok = reader.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      ids.push_back(order.id);
+    }
+    return true;
+  });
+  error = reader.error_line();
+  return ids;
+}
+
+} // namespace
+
+TEST(GzipDatasetTest, ReadsCompressedCsvInOrder) {
+  auto path = std::filesystem::temp_directory_path() / "fm_gzip_dataset.csv.gz";
+  // Large enough to span several decompressed blocks.
+  const std::size_t rows = 400000;
+  write_gzip(path, {make_csv(rows, 1000)});
+
+  DatasetReader reader(path.string());
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.header().total_rows, rows);
+  EXPECT_EQ(reader.header().warmup_rows, 1000u);
+
+  bool ok = false;
+  std::string error;
+  auto ids = read_ids(path.string(), ok, error);
+  EXPECT_TRUE(ok) << error;
+  ASSERT_EQ(ids.size(), rows);
+  for (std::size_t i = 0; i < rows; ++i) {
+    ASSERT_EQ(ids[i], i + 1);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(GzipDatasetTest, ReadsConcatenatedMembers) {
+  auto path = std::filesystem::temp_directory_path() / "fm_gzip_members.csv.gz";
+  std::string csv = make_csv(10, 0);
+  auto split = csv.find("6,");
+  // The split falls mid-file, so the second member continues the first.
+  write_gzip(path, {csv.substr(0, split + 1), csv.substr(split + 1)});
+
+  bool ok = false;
+  std::string error;
+  auto ids = read_ids(path.string(), ok, error);
+  EXPECT_TRUE(ok) << error;
+  EXPECT_EQ(ids.size(), 10u);
+  std::filesystem::remove(path);
+}
+
+TEST(GzipDatasetTest, ReportsTruncatedStream) {
+  auto path = std::filesystem::temp_directory_path() / "fm_gzip_truncated.csv.gz";
+  write_gzip(path, {make_csv(50000, 0)});
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+
+  bool ok = true;
+  std::string error;
+  read_ids(path.string(), ok, error);
+  EXPECT_FALSE(ok);
+  EXPECT_FALSE(error.empty());
+  std::filesystem::remove(path);
+}
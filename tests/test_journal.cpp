@@ -0,0 +1,175 @@
+#include "flashmatch/journal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sys/resource.h>
+
+#include <csignal>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flashmatch/mapped_file.hpp"
+
+using namespace fm;
+
+namespace {
+
+Order order_for(std::uint64_t id) {
+  return Order{id,
+               id % 3 == 0 ? "AAPL" : "A_RATHER_LONG_SYMBOL_NAME",
+               id % 2 == 0 ? Side::BUY : Side::SELL,
+               100.0 + static_cast<double>(id % 7),
+               id * 10,
+               id % 5 == 0 ? OrderType::IOC : OrderType::LIMIT};
+}
+
+// Every record of the journal at path, checking sequences run from first.
+std::vector<Order> read_journal(const std::filesystem::path &path, std::uint64_t first,
+                                bool &clean_end) {
+  MappedFile file(path.string());
+  JournalReader reader;
+  EXPECT_TRUE(reader.open(file.view()));
+  std::vector<Order> orders;
+  std::uint64_t sequence = 0;
+  Order order{};
+  while (reader.next(sequence, order)) {
+    EXPECT_EQ(sequence, first + orders.size());
+    orders.push_back(order);
+  }
+  clean_end = reader.at_end();
+  return orders;
+}
+
+} // namespace
+
+TEST(JournalTest, AppendedOrdersBecomeDurable) {
+  auto path = std::filesystem::temp_directory_path() / "fm_journal_append.fmj";
+  std::filesystem::remove(path);
+  std::vector<std::uint64_t> acks;
+  {
+    JournalOptions options;
+    options.group_commit_orders = 64;
+    options.queue_capacity = 256; // Small enough for append() to wait on it.
+    options.on_durable = [&](std::uint64_t sequence) { acks.push_back(sequence); };
+    Journal journal(path.string(), 41, options);
+    ASSERT_TRUE(journal.ok()) << journal.error();
+    for (std::uint64_t id = 1; id <= 1000; ++id) {
+      EXPECT_EQ(journal.append(order_for(id)), 41 + id);
+    }
+    EXPECT_TRUE(journal.wait_durable(1041));
+    EXPECT_GE(journal.syncs(), 1000u / 64);
+  }
+  ASSERT_FALSE(acks.empty());
+  EXPECT_TRUE(std::is_sorted(acks.begin(), acks.end()));
+  EXPECT_EQ(acks.back(), 1041u);
+
+  bool clean_end = false;
+  std::vector<Order> orders = read_journal(path, 42, clean_end);
+  EXPECT_TRUE(clean_end);
+  ASSERT_EQ(orders.size(), 1000u);
+  for (std::uint64_t id = 1; id <= 1000; ++id) {
+    const Order expected = order_for(id);
+    const Order &actual = orders[id - 1];
+    EXPECT_EQ(actual.id, expected.id);
+    EXPECT_EQ(actual.symbol, expected.symbol);
+    EXPECT_EQ(actual.side, expected.side);
+    EXPECT_EQ(actual.price, expected.price);
+    EXPECT_EQ(actual.quantity, expected.quantity);
+    EXPECT_EQ(actual.type, expected.type);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(JournalTest, ReopenDropsTornRecord) {
+  auto path = std::filesystem::temp_directory_path() / "fm_journal_torn.fmj";
+  std::filesystem::remove(path);
+  {
+    Journal journal(path.string(), 0);
+    ASSERT_TRUE(journal.ok()) << journal.error();
+    for (std::uint64_t id = 1; id <= 10; ++id) {
+      journal.append(order_for(id));
+    }
+  }
+  // Half of an eleventh record, as a crash mid-write would leave.
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    JournalRecord partial{11, 11, 1.0, 1, 4, 0, 0, 0};
+    file.write(reinterpret_cast<const char *>(&partial), sizeof(partial) / 2);
+  }
+  bool clean_end = true;
+  EXPECT_EQ(read_journal(path, 1, clean_end).size(), 10u);
+  EXPECT_FALSE(clean_end);
+
+  // The journal must continue from the engine's sequence.
+  EXPECT_FALSE(Journal(path.string(), 9).ok());
+  {
+    Journal journal(path.string(), 10);
+    ASSERT_TRUE(journal.ok()) << journal.error();
+    EXPECT_EQ(journal.append(order_for(11)), 11u);
+  }
+  std::vector<Order> orders = read_journal(path, 1, clean_end);
+  EXPECT_TRUE(clean_end);
+  ASSERT_EQ(orders.size(), 11u);
+  EXPECT_EQ(orders.back().id, 11u);
+  std::filesystem::remove(path);
+}
+
+TEST(JournalTest, AppendStopsAfterWriteFailure) {
+  auto path = std::filesystem::temp_directory_path() / "fm_journal_failed.fmj";
+  std::filesystem::remove(path);
+  // A file size limit makes the journal's writes fail with EFBIG once the
+  // file reaches 1 KiB.
+  std::signal(SIGXFSZ, SIG_IGN);
+  rlimit saved{};
+  ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &saved), 0);
+  rlimit limited = saved;
+  limited.rlim_cur = 1024;
+  ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limited), 0);
+  {
+    JournalOptions options;
+    options.group_commit_orders = 0; // Clamped to 1: every order is synced alone.
+    Journal journal(path.string(), 0, options);
+    ASSERT_TRUE(journal.ok()) << journal.error();
+    std::uint64_t last = 0;
+    for (std::uint64_t id = 1; id <= 100; ++id) {
+      last = std::max(last, journal.append(order_for(id)));
+    }
+    for (int i = 0; i < 5000 && !journal.failed(); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(journal.failed());
+    EXPECT_EQ(journal.append(order_for(101)), 0u);
+    EXPECT_FALSE(journal.wait_durable(last));
+    EXPECT_LT(journal.durable_sequence(), 100u);
+    EXPECT_GT(journal.durable_sequence(), 0u);
+  }
+  setrlimit(RLIMIT_FSIZE, &saved);
+  std::signal(SIGXFSZ, SIG_DFL);
+  std::filesystem::remove(path);
+}
+
+TEST(JournalTest, RejectsSymbolTooLongForRecord) {
+  auto path = std::filesystem::temp_directory_path() / "fm_journal_long_symbol.fmj";
+  std::filesystem::remove(path);
+  {
+    Journal journal(path.string(), 0);
+    ASSERT_TRUE(journal.ok()) << journal.error();
+    Order order = order_for(1);
+    order.symbol = std::string(70000, 'S');
+    EXPECT_EQ(journal.append(order), 0u);
+    EXPECT_EQ(journal.append(order_for(2)), 1u);
+    EXPECT_TRUE(journal.wait_durable(1));
+  }
+  bool clean_end = false;
+  std::vector<Order> orders = read_journal(path, 1, clean_end);
+  EXPECT_TRUE(clean_end);
+  ASSERT_EQ(orders.size(), 1u);
+  EXPECT_EQ(orders[0].id, 2u);
+  std::filesystem::remove(path);
+}
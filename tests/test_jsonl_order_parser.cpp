@@ -0,0 +1,89 @@
+#include "flashmatch/jsonl_order_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "flashmatch/dataset_reader.hpp"
+
+using namespace fm;
+
+TEST(JsonlOrderParserTest, ParsesPandasRecord) {
+  Order order;
+  ASSERT_TRUE(parse_order_json(
+      R"({"id":7,"symbol":"GOOG","side":"SELL","price":10.37,"quantity":58,"type":"IOC"})",
+      order));
+  EXPECT_EQ(order.id, 7u);
+  EXPECT_EQ(order.symbol, "GOOG");
+  EXPECT_EQ(order.side, Side::SELL);
+  EXPECT_EQ(order.price, 10.37);
+  EXPECT_EQ(order.quantity, 58u);
+  EXPECT_EQ(order.type, OrderType::IOC);
+}
+
+TEST(JsonlOrderParserTest, AcceptsAnyKeyOrderAndUnknownKeys) {
+  Order order;
+  ASSERT_TRUE(parse_order_json(R"({ "type" : "LIMIT", "venue": "X", "quantity": 3,
+      "price": 9.5, "ts": 1.5e9, "side": "BUY", "live": true, "symbol": "BRK\/B", "id": 11 })",
+                               order));
+  EXPECT_EQ(order.id, 11u);
+  EXPECT_EQ(order.symbol, "BRK/B");
+  EXPECT_EQ(order.side, Side::BUY);
+  EXPECT_EQ(order.price, 9.5);
+  EXPECT_EQ(order.quantity, 3u);
+  EXPECT_EQ(order.type, OrderType::LIMIT);
+}
+
+TEST(JsonlOrderParserTest, RejectsMissingOrMistypedFields) {
+  Order order;
+  EXPECT_FALSE(parse_order_json(R"({"id":1,"symbol":"AAPL","side":"BUY","price":9.5})", order));
+  EXPECT_FALSE(parse_order_json(
+      R"({"id":"1","symbol":"AAPL","side":"BUY","price":9.5,"quantity":1,"type":"LIMIT"})", order));
+  EXPECT_FALSE(parse_order_json(
+      R"({"id":1,"symbol":"AAPL","side":"BUY","price":9.5,"quantity":1,"type":"LIMIT")", order));
+}
+
+TEST(JsonlOrderParserTest, ScannerHandlesObjectsWithoutNewlines) {
+  // Older pandas versions omit the newline between to_json batches.
+  std::string data =
+      R"({"id":1,"symbol":"A","side":"BUY","price":1.0,"quantity":1,"type":"LIMIT"})"
+      "\n"
+      R"({"id":2,"symbol":"B","side":"BUY","price":2.0,"quantity":2,"type":"LIMIT"})"
+      R"({"id":3,"symbol":"C","side":"SELL","price":3.0,"quantity":3,"type":"IOC"})"
+      "\r\n";
+  JsonOrderScanner scanner(data.data(), data.data() + data.size());
+  Order order;
+  std::uint64_t expected = 1;
+  while (scanner.next(order)) {
+    EXPECT_EQ(order.id, expected++);
+  }
+  EXPECT_FALSE(scanner.failed());
+  EXPECT_EQ(expected, 4u);
+}
+
+TEST(JsonlOrderParserTest, DatasetReaderDetectsJsonLines) {
+  auto path = std::filesystem::temp_directory_path() / "fm_dataset.json";
+  {
+    std::ofstream out(path, std::ios::trunc);
+    out << "3000,1000\n";
+    for (int i = 1; i <= 3000; ++i) {
+      out << R"({"id":)" << i << R"(,"symbol":"AAPL","side":")" << (i % 2 ? "BUY" : "SELL")
+          << R"(","price":10.25,"quantity":)" << i % 100 + 1 << R"(,"type":")"
+          << (i <= 1000 ? "LIMIT" : "IOC") << "\"}\n";
+    }
+  }
+  DatasetReader reader(path.string(), 3, 4096);
+  ASSERT_TRUE(reader.is_open());
+  EXPECT_EQ(reader.header().total_rows, 3000u);
+  std::uint64_t expected = 1;
+  EXPECT_TRUE(reader.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      EXPECT_EQ(order.id, expected++);
+    }
+    return true;
+  })) << reader.error_line();
+  EXPECT_EQ(expected, 3001u);
+  std::filesystem::remove(path);
+}
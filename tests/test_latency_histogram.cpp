@@ -0,0 +1,71 @@
+#include "flashmatch/latency_histogram.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace fm;
+
+TEST(LatencyHistogramTest, BucketsCoverRangeWithBoundedError) {
+  std::uint64_t values[] = {0,      1,       127,           128,       129,
+                            255,    256,     1000,          123456789, UINT64_MAX / 3,
+                            UINT64_MAX};
+  for (std::uint64_t v : values) {
+    std::size_t index = LatencyHistogram::bucket_index(v);
+    ASSERT_LT(index, LatencyHistogram::kBucketCount);
+    std::uint64_t upper = LatencyHistogram::bucket_upper_bound(index);
+    EXPECT_GE(upper, v);
+    EXPECT_LE(static_cast<double>(upper - v), static_cast<double>(v) / 128.0) << v;
+    if (index > 0) {
+      EXPECT_LT(LatencyHistogram::bucket_upper_bound(index - 1), v);
+    }
+  }
+}
+
+TEST(LatencyHistogramTest, PercentilesMatchSortedSamples) {
+  std::mt19937_64 rng(7);
+  std::lognormal_distribution<double> dist(6.0, 1.0);
+  LatencyHistogram histogram;
+  std::vector<std::uint64_t> samples;
+  for (int i = 0; i < 200000; ++i) {
+    auto v = static_cast<std::uint64_t>(dist(rng));
+    samples.push_back(v);
+    histogram.record(v);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  EXPECT_EQ(histogram.count(), samples.size());
+  EXPECT_EQ(histogram.min(), samples.front());
+  EXPECT_EQ(histogram.max(), samples.back());
+  EXPECT_EQ(histogram.percentile(100.0), samples.back());
+  for (double p : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+    auto exact = samples[static_cast<std::size_t>(std::ceil(p / 100.0 * samples.size())) - 1];
+    auto got = histogram.percentile(p);
+    EXPECT_GE(got, exact) << p;
+    EXPECT_LE(static_cast<double>(got - exact), exact / 128.0 + 1) << p;
+  }
+}
+
+TEST(LatencyHistogramTest, MergeEqualsSingleHistogram) {
+  LatencyHistogram all, left, right;
+  for (std::uint64_t v = 1; v <= 100000; ++v) {
+    all.record(v * 7);
+    (v % 2 ? left : right).record(v * 7);
+  }
+  left.merge(right);
+  EXPECT_EQ(left.count(), all.count());
+  EXPECT_EQ(left.min(), all.min());
+  EXPECT_EQ(left.max(), all.max());
+  EXPECT_DOUBLE_EQ(left.mean(), all.mean());
+  for (double p : {0.0, 50.0, 99.0, 99.999}) {
+    EXPECT_EQ(left.percentile(p), all.percentile(p));
+  }
+
+  left.reset();
+  EXPECT_EQ(left.count(), 0u);
+  EXPECT_EQ(left.percentile(99.0), 0u);
+  EXPECT_EQ(left.max(), 0u);
+}
@@ -300,3 +300,20 @@ TEST(AtomicQueueTest, FullAtCapacity) {
   EXPECT_EQ(q.pop(), 5);
   EXPECT_TRUE(q.isEmpty());
 }
+
+// 31. depth() follows pushes and pops, including across wrap-around
+TEST(AtomicQueueTest, DepthTracksEntries) {
+  Atomic_Queue<int> q(3);
+  EXPECT_EQ(q.depth(), 0u);
+  q.push(1);
+  q.push(2);
+  EXPECT_EQ(q.depth(), 2u);
+  q.pop();
+  q.push(3);
+  q.push(4);
+  EXPECT_EQ(q.depth(), 3u);
+  q.pop();
+  q.pop();
+  q.pop();
+  EXPECT_EQ(q.depth(), 0u);
+}
@@ -1,7 +1,15 @@
 #include "flashmatch/matching_engine.hpp"
 #include <gtest/gtest.h>
 
+#include <map>
+#include <span>
+
+#include "engine_test_helpers.hpp"
+#include "flashmatch/order_generator.hpp"
+
 using namespace fm;
+using fm::test::expect_same_trades;
+using fm::test::generate_flow;
 
 TEST(MatchingEngineTest, LimitOrderMatching) {
   MatchingEngine me;
@@ -84,3 +92,142 @@ TEST(MatchingEngineTest, QueuedOrdersMatchOnRun) {
   EXPECT_EQ(trades[0].price, 10.0);
 }
 
+
+TEST(MatchingEngineTest, GroupedRunMatchesPerSymbolOrder) {
+  GeneratorConfig config;
+  config.total_orders = 20000;
+  config.warmup_orders = 2000;
+  config.symbol_count = 7;
+  OrderGenerator generator(config);
+  MatchingEngine arrival, grouped;
+  std::map<std::uint64_t, std::string> symbol_of;
+  std::size_t seen = 0;
+  generator.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      symbol_of[order.id] = order.symbol;
+      if (seen++ < config.warmup_orders) {
+        arrival.insert(order);
+        grouped.insert(order);
+      } else {
+        arrival.add(order);
+        grouped.add(order);
+      }
+    }
+    return true;
+  });
+
+  auto by_symbol = [&](const std::vector<Trade> &trades) {
+    std::map<std::string, std::vector<Trade>> split;
+    for (const Trade &trade : trades) {
+      split[symbol_of.at(trade.taker_id)].push_back(trade);
+    }
+    return split;
+  };
+  auto expected = by_symbol(arrival.run());
+  auto actual = by_symbol(grouped.run_grouped());
+  ASSERT_EQ(expected.size(), actual.size());
+  for (const auto &[symbol, trades] : expected) {
+    const std::vector<Trade> &got = actual.at(symbol);
+    ASSERT_EQ(got.size(), trades.size()) << symbol;
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+      EXPECT_EQ(got[i].maker_id, trades[i].maker_id);
+      EXPECT_EQ(got[i].taker_id, trades[i].taker_id);
+      EXPECT_EQ(got[i].quantity, trades[i].quantity);
+      EXPECT_EQ(got[i].price, trades[i].price);
+    }
+  }
+  EXPECT_TRUE(grouped.run_grouped().empty());
+}
+
+namespace {
+
+class RecordingSink : public TradeSink {
+public:
+  void on_trades(const Order &order, std::span<const Trade> trades) override {
+    takers.push_back(order.id);
+    this->trades.insert(this->trades.end(), trades.begin(), trades.end());
+  }
+  std::vector<std::uint64_t> takers;
+  std::vector<Trade> trades;
+};
+
+} // namespace
+
+TEST(MatchingEngineTest, SubmitBatchMatchesSubmit) {
+  std::vector<Order> orders = {
+      {1, "AAPL", Side::SELL, 10.0, 100, OrderType::LIMIT},
+      {2, "MSFT", Side::SELL, 20.0, 10, OrderType::LIMIT},
+      {3, "AAPL", Side::BUY, 10.0, 40, OrderType::LIMIT},
+      {4, "AAPL", Side::BUY, 10.0, 70, OrderType::IOC},
+      {5, "MSFT", Side::BUY, 19.0, 10, OrderType::LIMIT},
+      {6, "MSFT", Side::BUY, 20.0, 15, OrderType::LIMIT},
+  };
+  MatchingEngine one_by_one, batched;
+  std::vector<Trade> expected;
+  for (const Order &order : orders) {
+    auto trades = one_by_one.submit(order);
+    expected.insert(expected.end(), trades.begin(), trades.end());
+  }
+  RecordingSink sink;
+  batched.submit_batch(orders, sink);
+
+  EXPECT_EQ(sink.takers, (std::vector<std::uint64_t>{3, 4, 6}));
+  ASSERT_EQ(sink.trades.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(sink.trades[i].maker_id, expected[i].maker_id);
+    EXPECT_EQ(sink.trades[i].taker_id, expected[i].taker_id);
+    EXPECT_EQ(sink.trades[i].quantity, expected[i].quantity);
+  }
+  // Both engines are left with the same resting orders.
+  Order sweep{7, "MSFT", Side::SELL, 1.0, 100, OrderType::IOC};
+  EXPECT_EQ(one_by_one.submit(sweep).size(), batched.submit(sweep).size());
+}
+
+TEST(MatchingEngineTest, PendingQueueIsReusedAcrossRuns) {
+  MatchingEngine me;
+  for (int round = 0; round < 3; ++round) {
+    Order ask{static_cast<std::uint64_t>(round * 2 + 1), "AAPL", Side::SELL, 10.0, 5,
+              OrderType::LIMIT};
+    me.add(std::move(ask));
+    me.add(Order{static_cast<std::uint64_t>(round * 2 + 2), "AAPL", Side::BUY, 10.0, 5,
+                 OrderType::LIMIT});
+    auto trades = me.run();
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(trades[0].maker_id, static_cast<std::uint64_t>(round * 2 + 1));
+  }
+  EXPECT_TRUE(me.run().empty());
+}
+
+TEST(MatchingEngineTest, BulkInsertMatchesSequentialInserts) {
+  std::vector<Order> warmup, measured;
+  generate_flow(5, warmup, measured);
+  for (Allocation allocation : {Allocation::Fifo, Allocation::TopOrderProRata}) {
+    SCOPED_TRACE(allocation_name(allocation));
+    MatchingEngine sequential(AllocationRules{allocation, {}});
+    MatchingEngine bulk(AllocationRules{allocation, {}});
+    for (const Order &order : warmup) {
+      sequential.insert(order);
+    }
+    // In chunks, so later loads land on books that already have levels.
+    std::span<const Order> rest(warmup);
+    for (std::size_t chunk : {1000, 2500, 2500}) {
+      bulk.bulk_insert(rest.first(chunk));
+      rest = rest.subspan(chunk);
+    }
+    expect_same_trades(sequential, bulk, measured);
+  }
+}
+
+TEST(MatchingEngineTest, ParallelBulkInsertMatchesSequentialInserts) {
+  std::vector<Order> warmup, measured;
+  generate_flow(64, warmup, measured);
+  MatchingEngine sequential, parallel;
+  for (const Order &order : warmup) {
+    sequential.insert(order);
+  }
+  std::span<const Order> all(warmup);
+  parallel.bulk_insert(all.first(3000), 4);
+  parallel.bulk_insert(all.subspan(3000), 4);
+  EXPECT_EQ(parallel.book_count(), 64u);
+  expect_same_trades(sequential, parallel, measured);
+}
@@ -0,0 +1,143 @@
+#include "flashmatch/metrics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "flashmatch/matching_engine.hpp"
+
+using namespace fm;
+
+namespace {
+
+const SymbolMetrics *find_symbol(const MetricsSnapshot &snapshot, const std::string &symbol) {
+  for (const SymbolMetrics &entry : snapshot.symbols) {
+    if (entry.symbol == symbol) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+std::string http_get(int port, const std::string &path) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(static_cast<std::uint16_t>(port));
+  std::string response;
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    char buf[4096];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+      response.append(buf, static_cast<std::size_t>(n));
+    }
+  }
+  close(fd);
+  return response;
+}
+
+} // namespace
+
+TEST(MetricsTest, CountersSumAcrossThreads) {
+  MetricsRegistry &registry = MetricsRegistry::instance();
+  std::uint64_t before = registry.snapshot()[Counter::QueuePushFailures];
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 1000; ++i) {
+        MetricsRegistry::add(Counter::QueuePushFailures);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // Totals survive the threads that produced them.
+  EXPECT_EQ(registry.snapshot()[Counter::QueuePushFailures] - before, 4000u);
+}
+
+TEST(MetricsTest, EngineAndBookHooks) {
+  MetricsRegistry &registry = MetricsRegistry::instance();
+  MetricsSnapshot before = registry.snapshot();
+  {
+    MatchingEngine engine;
+    engine.insert(Order{1, "METRICS_A", Side::SELL, 10.0, 50, OrderType::LIMIT});
+    engine.insert(Order{2, "METRICS_A", Side::SELL, 10.0, 50, OrderType::LIMIT});
+    engine.insert(Order{3, "METRICS_A", Side::SELL, 10.5, 50, OrderType::LIMIT});
+    engine.insert(Order{4, "METRICS_B", Side::BUY, 9.0, 10, OrderType::LIMIT});
+    // Fills order 1 and half of 2, then drops 20 unfilled at 10.0.
+    engine.submit(Order{5, "METRICS_A", Side::BUY, 10.0, 95, OrderType::IOC});
+    engine.submit(Order{6, "METRICS_A", Side::BUY, 10.0, 120, OrderType::IOC});
+
+    MetricsSnapshot after = registry.snapshot();
+    EXPECT_EQ(after[Counter::OrdersIn] - before[Counter::OrdersIn], 6u);
+    EXPECT_EQ(after[Counter::TradesOut] - before[Counter::TradesOut], 3u);
+    EXPECT_EQ(after[Counter::IocRemaindersDropped] - before[Counter::IocRemaindersDropped], 1u);
+    const SymbolMetrics *a = find_symbol(after, "METRICS_A");
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(a->levels, 1);
+    EXPECT_EQ(a->orders, 1);
+    const SymbolMetrics *b = find_symbol(after, "METRICS_B");
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(b->orders, 1);
+  }
+  // Destroying the engine releases its books' gauges.
+  EXPECT_EQ(find_symbol(registry.snapshot(), "METRICS_A"), nullptr);
+}
+
+TEST(MetricsTest, PrometheusFormat) {
+  MetricsSnapshot snapshot;
+  snapshot.counters[static_cast<std::size_t>(Counter::OrdersIn)] = 42;
+  snapshot.symbols.push_back({"SYM0", 3, 7});
+  snapshot.gauges.emplace_back("queue_depth", 5);
+  std::ostringstream out;
+  write_prometheus(out, snapshot);
+  std::string text = out.str();
+  EXPECT_NE(text.find("# TYPE flashmatch_orders_in_total counter\nflashmatch_orders_in_total 42\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("flashmatch_book_levels{symbol=\"SYM0\"} 3\n"), std::string::npos);
+  EXPECT_NE(text.find("flashmatch_book_orders{symbol=\"SYM0\"} 7\n"), std::string::npos);
+  EXPECT_NE(text.find("flashmatch_queue_depth 5\n"), std::string::npos);
+}
+
+TEST(MetricsTest, ExporterWritesFileAndServesHttp) {
+  MetricsRegistry registry;
+  registry.add_gauge("test_gauge", [] { return std::int64_t{17}; });
+  auto path = std::filesystem::temp_directory_path() / "flashmatch_metrics_test.prom";
+  std::filesystem::remove(path);
+  {
+    ExporterOptions options;
+    options.interval = std::chrono::milliseconds(10);
+    options.text_path = path.string();
+    options.http_port = 0;
+    MetricsExporter exporter(options, registry);
+    ASSERT_TRUE(exporter.ok()) << exporter.error();
+    ASSERT_GT(exporter.port(), 0);
+
+    std::string response = http_get(exporter.port(), "/metrics");
+    EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK")) << response;
+    EXPECT_NE(response.find("flashmatch_test_gauge 17\n"), std::string::npos);
+    EXPECT_TRUE(http_get(exporter.port(), "/other").starts_with("HTTP/1.1 404"));
+
+    for (int i = 0; i < 100 && !std::filesystem::exists(path); ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  EXPECT_NE(text.str().find("flashmatch_test_gauge 17\n"), std::string::npos);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,101 @@
+#include "flashmatch/order_generator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+#include "flashmatch/matching_engine.hpp"
+
+using namespace fm;
+
+namespace {
+
+GeneratorConfig small_config() {
+  GeneratorConfig config;
+  config.total_orders = 50'000;
+  config.warmup_orders = 10'000;
+  config.symbol_count = 8;
+  return config;
+}
+
+std::vector<Order> collect(OrderGenerator &generator) {
+  std::vector<Order> orders;
+  generator.for_each_batch([&](std::span<const Order> batch) {
+    orders.insert(orders.end(), batch.begin(), batch.end());
+    return true;
+  });
+  return orders;
+}
+
+} // namespace
+
+TEST(OrderGeneratorTest, SameSeedSameFlow) {
+  OrderGenerator a(small_config());
+  OrderGenerator b(small_config());
+  std::vector<Order> first = collect(a);
+  std::vector<Order> second = collect(b);
+  ASSERT_EQ(first.size(), 50'000u);
+  ASSERT_EQ(first.size(), second.size());
+  for (std::size_t i = 0; i < first.size(); ++i) {
+    EXPECT_EQ(first[i].symbol, second[i].symbol);
+    EXPECT_EQ(first[i].price, second[i].price);
+    EXPECT_EQ(first[i].quantity, second[i].quantity);
+    EXPECT_EQ(first[i].side, second[i].side);
+    EXPECT_EQ(first[i].type, second[i].type);
+  }
+
+  // for_each_batch restarts the stream, and next() continues it.
+  Order order;
+  a.reset();
+  a.next(order);
+  EXPECT_EQ(order.id, 1u);
+  EXPECT_EQ(order.price, first[0].price);
+}
+
+TEST(OrderGeneratorTest, RespectsConfig) {
+  GeneratorConfig config = small_config();
+  OrderGenerator generator(config);
+  std::vector<Order> orders = collect(generator);
+
+  std::set<std::string> symbols;
+  std::size_t ioc = 0;
+  for (std::size_t i = 0; i < orders.size(); ++i) {
+    const Order &order = orders[i];
+    EXPECT_EQ(order.id, i + 1);
+    EXPECT_GE(order.quantity, config.min_quantity);
+    EXPECT_LE(order.quantity, config.max_quantity);
+    EXPECT_GT(order.price, 0.0);
+    // Prices sit on the tick grid.
+    double ticks = order.price / config.tick_size;
+    EXPECT_NEAR(ticks, std::round(ticks), 1e-6);
+    symbols.insert(order.symbol);
+    if (i < config.warmup_orders) {
+      EXPECT_EQ(order.type, OrderType::LIMIT);
+    } else if (order.type == OrderType::IOC) {
+      ++ioc;
+    }
+  }
+  EXPECT_EQ(symbols.size(), config.symbol_count);
+  double ioc_share = static_cast<double>(ioc) / (config.total_orders - config.warmup_orders);
+  EXPECT_NEAR(ioc_share, config.ioc_ratio, 0.02);
+}
+
+TEST(OrderGeneratorTest, FeedsEngineAndQueue) {
+  OrderGenerator generator(small_config());
+  MatchingEngine engine;
+  std::size_t trades = 0;
+  generator.for_each_batch([&](std::span<const Order> batch) {
+    for (const Order &order : batch) {
+      trades += engine.submit(order).size();
+    }
+    return true;
+  });
+  EXPECT_GT(trades, 0u);
+
+  lfq::Atomic_Queue<Order> queue(1024);
+  generator.reset();
+  generator.push_to(queue, 100);
+  EXPECT_EQ(queue.pop().id, 1u);
+}
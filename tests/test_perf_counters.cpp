@@ -0,0 +1,56 @@
+#include "flashmatch/perf_counters.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "flashmatch/benchmark.hpp"
+#include "flashmatch/order_generator.hpp"
+
+using namespace fm;
+
+TEST(PerfCountersTest, CountsOrExplainsWhyNot) {
+  PerfCounters counters;
+  if (!counters.available()) {
+    // Containers and VMs without a PMU must degrade, not fail.
+    EXPECT_FALSE(counters.error().empty());
+    counters.reset();
+    counters.enable();
+    counters.disable();
+    EXPECT_FALSE(counters.read().any());
+    return;
+  }
+  counters.reset();
+  counters.enable();
+  volatile std::uint64_t sink = 0;
+  for (int i = 0; i < 100000; ++i) {
+    sink = sink + static_cast<std::uint64_t>(i);
+  }
+  counters.disable();
+  PerfCounts counts = counters.read();
+  ASSERT_TRUE(counts.any());
+  if (counts.has(PerfEvent::Instructions)) {
+    EXPECT_GT(counts[PerfEvent::Instructions], 100000u);
+  }
+
+  // Disabled counters do not advance.
+  PerfCounts again = counters.read();
+  EXPECT_EQ(again.values, counts.values);
+}
+
+TEST(PerfCountersTest, BenchReportsPhasesSeparately) {
+  GeneratorConfig config;
+  config.total_orders = 20000;
+  config.warmup_orders = 5000;
+  BenchOptions options;
+  options.perf_counters = true;
+  BenchStats stats = run_bench(config, options);
+  EXPECT_EQ(stats.num_orders, 15000u);
+  if (PerfCounters().available()) {
+    EXPECT_TRUE(stats.warmup_counters.any());
+    EXPECT_TRUE(stats.bench_counters.any());
+  } else {
+    EXPECT_FALSE(stats.perf_note.empty());
+  }
+  output_perf_counts(stats);
+}
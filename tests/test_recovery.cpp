@@ -0,0 +1,163 @@
+#include "flashmatch/recovery.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "engine_test_helpers.hpp"
+#include "flashmatch/flashmatch.hpp"
+#include "flashmatch/journal.hpp"
+#include "flashmatch/matching_engine.hpp"
+
+using namespace fm;
+using fm::test::expect_same_trades;
+using fm::test::generate_orders;
+
+namespace {
+
+// Journals and submits orders[0, crash), snapshotting after `snapshot_at`
+// orders, as a live engine would before crashing. Files live in a
+// directory named after the running test, so tests can run in parallel.
+struct CrashedRun {
+  std::filesystem::path dir =
+      std::filesystem::temp_directory_path() /
+      (std::string("fm_recovery_") +
+       ::testing::UnitTest::GetInstance()->current_test_info()->name());
+  std::filesystem::path snapshot = dir / "engine.snap";
+  std::filesystem::path journal = dir / "orders.fmj";
+
+  CrashedRun(MatchingEngine &live, const std::vector<Order> &orders, std::size_t snapshot_at,
+             std::size_t crash) {
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    Journal writer(journal.string(), live.sequence());
+    EXPECT_TRUE(writer.ok()) << writer.error();
+    for (std::size_t i = 0; i < crash; ++i) {
+      if (i == snapshot_at) {
+        EXPECT_TRUE(live.save_snapshot(snapshot.string()));
+      }
+      writer.append(orders[i]);
+      live.submit(orders[i]);
+    }
+  }
+  ~CrashedRun() { std::filesystem::remove_all(dir); }
+};
+
+} // namespace
+
+TEST(RecoveryTest, SnapshotPlusJournalTailRestoresEngine) {
+  std::vector<Order> orders = generate_orders(12000, 8);
+  MatchingEngine live;
+  CrashedRun run(live, orders, 3000, 8000);
+
+  MatchingEngine recovered;
+  RecoveryStats stats;
+  ASSERT_TRUE(recover(recovered, run.snapshot.string(), run.journal.string(), stats, 2));
+  EXPECT_EQ(stats.snapshot_sequence, 3000u);
+  EXPECT_EQ(stats.skipped, 3000u);
+  EXPECT_EQ(stats.replayed, 5000u);
+  EXPECT_FALSE(stats.torn_tail);
+  EXPECT_EQ(recovered.sequence(), live.sequence());
+
+  expect_same_trades(live, recovered, std::span<const Order>(orders).subspan(8000));
+}
+
+TEST(RecoveryTest, JournalMustContinueFromSnapshot) {
+  std::vector<Order> orders = generate_orders(2000, 8);
+  MatchingEngine live;
+  CrashedRun run(live, orders, 1500, 2000);
+
+  // A journal started after the snapshot leaves a gap.
+  auto late = run.dir / "late.fmj";
+  {
+    Journal writer(late.string(), 1600);
+    writer.append(orders[0]);
+  }
+  MatchingEngine engine;
+  RecoveryStats stats;
+  EXPECT_FALSE(recover(engine, run.snapshot.string(), late.string(), stats));
+
+  // The journal alone replays everything.
+  MatchingEngine from_journal;
+  ASSERT_TRUE(recover(from_journal, "", run.journal.string(), stats));
+  EXPECT_EQ(stats.replayed, 2000u);
+  EXPECT_EQ(from_journal.sequence(), 2000u);
+}
+
+TEST(RecoveryTest, UnsyncedTailIsIgnored) {
+  std::vector<Order> orders = generate_orders(101, 8);
+  MatchingEngine live;
+  CrashedRun run(live, orders, 100, 100);
+  const auto size = std::filesystem::file_size(run.journal);
+
+  // Zeros, as delayed allocation leaves after a power loss, then part of a
+  // record and garbage: none of it was synced.
+  {
+    std::ofstream file(run.journal, std::ios::binary | std::ios::app);
+    file << std::string(4096, '\0');
+    JournalRecord partial{101, 101, 1.0, 1, 4, 0, 0, 0};
+    file.write(reinterpret_cast<const char *>(&partial), sizeof(partial) / 2);
+    file << std::string(1000, 'x');
+  }
+  MatchingEngine recovered;
+  RecoveryStats stats;
+  ASSERT_TRUE(recover(recovered, "", run.journal.string(), stats));
+  EXPECT_TRUE(stats.torn_tail);
+  EXPECT_EQ(stats.replayed, 100u);
+  EXPECT_EQ(recovered.sequence(), 100u);
+
+  // Reopening drops the tail and appends after the last synced record.
+  {
+    Journal writer(run.journal.string(), 100);
+    ASSERT_TRUE(writer.ok()) << writer.error();
+    EXPECT_EQ(std::filesystem::file_size(run.journal), size);
+    EXPECT_EQ(writer.append(orders[100]), 101u);
+  }
+  MatchingEngine reopened;
+  ASSERT_TRUE(recover(reopened, "", run.journal.string(), stats));
+  EXPECT_FALSE(stats.torn_tail);
+  EXPECT_EQ(reopened.sequence(), 101u);
+}
+
+TEST(RecoveryTest, DamageBeforeSyncedRecordsFailsBeforeReplay) {
+  std::vector<Order> orders = generate_orders(100, 8);
+  MatchingEngine live;
+  CrashedRun run(live, orders, 100, 100);
+
+  // Record 50's quantity: every symbol is "SYMn", so records are 48 bytes.
+  // Records 51 to 100 are intact and were synced, so this is corruption.
+  {
+    std::fstream file(run.journal, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(sizeof(JournalHeader) + 49 * 48 + 24);
+    file.put('\x7f');
+  }
+  MatchingEngine damaged;
+  RecoveryStats stats;
+  EXPECT_FALSE(recover(damaged, "", run.journal.string(), stats));
+  EXPECT_EQ(damaged.sequence(), 0u);
+  EXPECT_EQ(damaged.book_count(), 0u);
+  // Reopening would truncate the synced records, so it is refused.
+  EXPECT_FALSE(Journal(run.journal.string(), 100).ok());
+}
+
+TEST(RecoveryTest, MainRecoversFromLatestSnapshot) {
+  std::vector<Order> orders = generate_orders(2000, 8);
+  MatchingEngine live;
+  CrashedRun run(live, orders, 500, 2000);
+  ASSERT_TRUE(live.save_snapshot((run.dir / "later.snap").string()));
+  EXPECT_EQ(latest_snapshot(run.dir.string()), (run.dir / "later.snap").string());
+
+  std::string dir = run.dir.string();
+  std::string journal = run.journal.string();
+  char *args[] = {const_cast<char *>("flashmatch"), const_cast<char *>("--recover"),
+                  const_cast<char *>("--snapshot"), dir.data(),
+                  const_cast<char *>("--journal"), journal.data()};
+  EXPECT_EQ(flashmatch_main(6, args), 0);
+
+  std::string missing = dir + "/missing.fmj";
+  args[5] = missing.data();
+  EXPECT_EQ(flashmatch_main(6, args), 1);
+}
@@ -0,0 +1,63 @@
+#include "flashmatch/scaling_bench.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "flashmatch/order_generator.hpp"
+
+using namespace fm;
+
+TEST(ScalingBenchTest, SplitsFlowAcrossThreads) {
+  GeneratorConfig config;
+  config.total_orders = 30000;
+  config.warmup_orders = 6000;
+  config.symbol_count = 6;
+  ScalingOptions options;
+  options.max_threads = 3;
+  options.cpus = {0};
+
+  std::vector<ScalingPoint> points = run_scaling_bench(config, options);
+  ASSERT_EQ(points.size(), 3u);
+  for (std::size_t n = 0; n < points.size(); ++n) {
+    const ScalingPoint &point = points[n];
+    EXPECT_EQ(point.threads, n + 1);
+    ASSERT_EQ(point.per_thread.size(), n + 1);
+    EXPECT_EQ(point.measured_orders, 24000u);
+    std::size_t total = 0;
+    for (const BenchStats &stats : point.per_thread) {
+      // Six symbols split evenly, so every thread gets work.
+      EXPECT_GT(stats.num_orders, 0u);
+      total += stats.total_orders;
+    }
+    EXPECT_EQ(total, 30000u);
+    EXPECT_GT(point.orders_per_sec, 0.0);
+  }
+
+  std::ostringstream csv;
+  write_scaling_csv_header(csv);
+  write_scaling_csv(csv, points.back());
+  std::size_t lines = 0;
+  for (char c : csv.str()) {
+    lines += c == '\n';
+  }
+  EXPECT_EQ(lines, 1u + 3u);
+  output_scaling(points);
+}
+
+TEST(ScalingBenchTest, StopsAtSymbolCount) {
+  GeneratorConfig config;
+  config.total_orders = 6000;
+  config.warmup_orders = 1000;
+  config.symbol_count = 2;
+  ScalingOptions options;
+  options.max_threads = 4;
+  options.cpus = {0};
+
+  // Threads 3 and 4 would get no symbols.
+  std::vector<ScalingPoint> points = run_scaling_bench(config, options);
+  ASSERT_EQ(points.size(), 2u);
+  for (const BenchStats &stats : points.back().per_thread) {
+    EXPECT_GT(stats.num_orders, 0u);
+  }
+}
@@ -0,0 +1,104 @@
+#include "flashmatch/snapshot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "engine_test_helpers.hpp"
+#include "flashmatch/matching_engine.hpp"
+
+using namespace fm;
+using fm::test::expect_same_trades;
+using fm::test::generate_orders;
+
+TEST(SnapshotTest, RestoredEngineMatchesOriginal) {
+  auto path = std::filesystem::temp_directory_path() / "fm_snapshot_roundtrip.snap";
+  std::vector<Order> orders = generate_orders(16000, 12);
+  std::span<const Order> all(orders);
+  // Mixed policies, so the restored books must keep each one, including
+  // top-order flags.
+  AllocationRules rules{Allocation::Fifo, {{"SYM1", Allocation::TopOrderProRata}}};
+
+  MatchingEngine original(rules);
+  for (const Order &order : all.first(8000)) {
+    original.submit(order);
+  }
+  ASSERT_TRUE(original.save_snapshot(path.string()));
+
+  // The rules of the restoring engine do not matter.
+  MatchingEngine restored;
+  ASSERT_TRUE(restored.load_snapshot(path.string(), 4));
+  EXPECT_EQ(restored.sequence(), 8000u);
+  EXPECT_EQ(restored.book_count(), original.book_count());
+
+  expect_same_trades(original, restored, all.subspan(8000));
+  EXPECT_EQ(restored.sequence(), original.sequence());
+  std::filesystem::remove(path);
+}
+
+TEST(SnapshotTest, RejectsCorruptFiles) {
+  auto path = std::filesystem::temp_directory_path() / "fm_snapshot_corrupt.snap";
+  MatchingEngine engine;
+  engine.insert({1, "AAPL", Side::BUY, 99.0, 10, OrderType::LIMIT});
+  engine.insert({2, "AAPL", Side::SELL, 101.0, 5, OrderType::LIMIT});
+  ASSERT_TRUE(engine.save_snapshot(path.string()));
+  EXPECT_EQ(std::filesystem::file_size(path),
+            sizeof(SnapshotHeader) + 8 + sizeof(SnapshotBook) + 2 * sizeof(SnapshotLevel) +
+                2 * sizeof(SnapshotOrder));
+
+  // A snapshot only loads into an empty engine.
+  EXPECT_FALSE(engine.load_snapshot(path.string()));
+
+  // Flip one byte of the last order's quantity.
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-16, std::ios::end);
+    file.put('\x7f');
+  }
+  MatchingEngine corrupted;
+  EXPECT_FALSE(corrupted.load_snapshot(path.string()));
+  EXPECT_EQ(corrupted.book_count(), 0u);
+
+  std::filesystem::resize_file(path, sizeof(SnapshotHeader) - 1);
+  EXPECT_FALSE(corrupted.load_snapshot(path.string()));
+  EXPECT_FALSE(corrupted.load_snapshot(path.string() + ".missing"));
+  std::filesystem::remove(path);
+}
+
+TEST(SnapshotTest, RejectsDuplicateSymbols) {
+  auto path = std::filesystem::temp_directory_path() / "fm_snapshot_duplicate.snap";
+  MatchingEngine engine;
+  engine.insert({1, "AA", Side::BUY, 99.0, 10, OrderType::LIMIT});
+  engine.insert({2, "AB", Side::SELL, 101.0, 5, OrderType::LIMIT});
+  ASSERT_TRUE(engine.save_snapshot(path.string()));
+
+  // Rename "AB" to "AA" in the symbol table ([u16 2]"AA"[u16 2]"AB") and
+  // fix up the checksum, so only the duplicate is wrong.
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    ASSERT_EQ(bytes[sizeof(SnapshotHeader) + 7], 'B');
+    bytes[sizeof(SnapshotHeader) + 7] = 'A';
+    SnapshotHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.crc32 = static_cast<std::uint32_t>(
+        crc32_z(crc32_z(0, nullptr, 0),
+                reinterpret_cast<const Bytef *>(bytes.data() + sizeof(header)),
+                bytes.size() - sizeof(header)));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    file.clear();
+    file.seekp(0);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  MatchingEngine duplicated;
+  EXPECT_FALSE(duplicated.load_snapshot(path.string(), 2));
+  EXPECT_EQ(duplicated.book_count(), 0u);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,91 @@
+#include "flashmatch/symbol_map.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "flashmatch/matching_engine.hpp"
+
+using namespace fm;
+
+TEST(SymbolMapTest, FindsInsertedSymbols) {
+  SymbolMap<int> map;
+  EXPECT_EQ(map.find("AAPL"), nullptr);
+  for (int i = 0; i < 1000; ++i) {
+    std::string symbol = "SYM" + std::to_string(i);
+    auto [value, inserted] = map.try_emplace(symbol, symbol_hash(symbol), i);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(*value, i);
+  }
+  EXPECT_EQ(map.size(), 1000u);
+  for (int i = 0; i < 1000; ++i) {
+    std::string symbol = "SYM" + std::to_string(i);
+    const int *value = map.find(symbol, symbol_hash(symbol));
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, i);
+  }
+  EXPECT_EQ(map.find("SYM1000"), nullptr);
+
+  auto [existing, inserted] = map.try_emplace("SYM7", symbol_hash("SYM7"), -1);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(*existing, 7);
+}
+
+TEST(SymbolMapTest, AddressesSurviveGrowth) {
+  SymbolMap<std::vector<int>> map;
+  std::vector<int> *first = map.try_emplace("FIRST", symbol_hash("FIRST")).first;
+  first->push_back(42);
+  for (int i = 0; i < 5000; ++i) {
+    std::string symbol = "SYM" + std::to_string(i);
+    map.try_emplace(symbol, symbol_hash(symbol));
+  }
+  EXPECT_EQ(map.find("FIRST"), first);
+  EXPECT_EQ(first->front(), 42);
+
+  // Iteration is in insertion order.
+  EXPECT_EQ(map.begin()->key, "FIRST");
+  EXPECT_EQ((map.end() - 1)->key, "SYM4999");
+}
+
+TEST(SymbolMapTest, CollidingHashesCompareKeys) {
+  SymbolMap<int> map;
+  map.try_emplace("A", 42u, 1);
+  map.try_emplace("B", 42u, 2);
+  map.try_emplace("C", 42 + (std::uint64_t{1} << 32), 3);
+  EXPECT_EQ(*map.find("A", 42), 1);
+  EXPECT_EQ(*map.find("B", 42), 2);
+  EXPECT_EQ(*map.find("C", 42 + (std::uint64_t{1} << 32)), 3);
+  EXPECT_EQ(map.find("D", 42), nullptr);
+}
+
+TEST(SymbolMapTest, EngineUsesCachedOrderHash) {
+  MatchingEngine engine;
+  engine.insert({1, "AAPL", Side::SELL, 100.0, 10, OrderType::LIMIT});
+
+  Order buy{2, "AAPL", Side::BUY, 100.0, 4, OrderType::LIMIT};
+  buy.symbol_hash = symbol_hash(buy.symbol);
+  EXPECT_EQ(engine.submit(buy).size(), 1u);
+  EXPECT_EQ(engine.book_count(), 1u);
+
+  const AnyOrderBook *book = engine.find_book(std::string_view("AAPL"));
+  ASSERT_NE(book, nullptr);
+  EXPECT_EQ(engine.find_book("MSFT"), nullptr);
+}
+
+TEST(SymbolMapTest, EngineRecomputesStaleOrderHash) {
+  MatchingEngine engine;
+  Order a{1, "AAPL", Side::SELL, 100.0, 10, OrderType::LIMIT};
+  a.symbol_hash = symbol_hash(a.symbol);
+  engine.insert(a);
+  engine.insert({2, "MSFT", Side::SELL, 200.0, 10, OrderType::LIMIT});
+
+  // A copy with a new symbol still carries AAPL's hash.
+  Order b = a;
+  b.id = 3;
+  b.symbol = "MSFT";
+  b.side = Side::BUY;
+  b.price = 200.0;
+  EXPECT_EQ(engine.submit(b).size(), 1u);
+  EXPECT_EQ(engine.book_count(), 2u);
+}
@@ -0,0 +1,48 @@
+#include "flashmatch/tsc_clock.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace fm;
+
+namespace {
+
+void expect_measures_sleep(const TscClock &clock) {
+  std::uint64_t start = clock.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  std::uint64_t ns = clock.to_ns(clock.stop() - start);
+  EXPECT_GE(ns, 4'500'000u) << clock.describe();
+  EXPECT_LT(ns, 500'000'000u) << clock.describe();
+}
+
+} // namespace
+
+TEST(TscClockTest, CalibratedClockMeasuresWallTime) {
+  TscClock clock;
+  EXPECT_EQ(clock.uses_tsc(), TscClock::invariant_tsc_available());
+  if (clock.uses_tsc()) {
+    // Any plausible TSC runs between 0.2 and 10 GHz.
+    EXPECT_GT(clock.ns_per_tick(), 0.1);
+    EXPECT_LT(clock.ns_per_tick(), 5.0);
+  }
+  expect_measures_sleep(clock);
+}
+
+TEST(TscClockTest, SteadyClockFallback) {
+  TscClock clock(false);
+  EXPECT_FALSE(clock.uses_tsc());
+  EXPECT_EQ(clock.ns_per_tick(), 1.0);
+  EXPECT_EQ(clock.describe(), "steady_clock");
+  expect_measures_sleep(clock);
+}
+
+TEST(TscClockTest, ReadingsAreMonotonic) {
+  const TscClock &clock = TscClock::instance();
+  std::uint64_t previous = clock.start();
+  for (int i = 0; i < 1000; ++i) {
+    std::uint64_t now = clock.stop();
+    EXPECT_GE(now, previous);
+    previous = now;
+  }
+}